@@ -20,38 +20,219 @@
 #include <ready_trader_go/logging.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <array>
 #include <boost/asio/io_context.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <type_traits>
 
 #include "ready_trader_go/baseautotrader.h"
+#include "ready_trader_go/error.h"
+#include "ready_trader_go/quotediff.h"
 #include "ready_trader_go/types.h"
 
 using namespace ReadyTraderGo;
 
-constexpr int LOT_SIZE = 10;
-constexpr int POSITION_LIMIT = 100;
-constexpr int TICK_SIZE_IN_CENTS = 100;
-constexpr int MIN_BID_NEARST_TICK = (MINIMUM_BID + TICK_SIZE_IN_CENTS) /
-                                    TICK_SIZE_IN_CENTS * TICK_SIZE_IN_CENTS;
-constexpr int MAX_ASK_NEAREST_TICK =
-    MAXIMUM_ASK / TICK_SIZE_IN_CENTS * TICK_SIZE_IN_CENTS;
+// Ticks to wait for order status messages after a reconnection
+constexpr ulong RESYNC_TICKS = 4;
+
+// The exchange's limits on our resting ETF orders (see exchange.json)
+constexpr ulong ACTIVE_ORDER_COUNT_LIMIT = 10;
+constexpr ulong ACTIVE_VOLUME_LIMIT = 200;
+
+// Quoting, taking and sweeping stop once this many messages have been sent
+// in the exchange's frequency interval, keeping the rest of the limit for
+// hedges
+constexpr std::size_t DISCRETIONARY_MESSAGE_LIMIT = MESSAGE_FREQUENCY_LIMIT - 10;
+
+// Once the unhedged lots deadline is near, hedging is retried this often,
+// one tick more aggressively each time until it will take any price
+constexpr std::chrono::seconds HEDGE_ESCALATION_INTERVAL{1};
+constexpr ulong HEDGE_ESCALATION_LEVELS = 5;
+
+// Seconds on the timers' clock, the time base of the unhedged lots deadline.
+// A backtest sets the clock to its simulated time.
+static double timerNow(const TimerService& timers) {
+  return std::chrono::duration<double>(timers.Now().time_since_epoch())
+      .count();
+}
 
 AutoTrader::AutoTrader(boost::asio::io_context& context)
-    : BaseAutoTrader(context) {}
+    : BaseAutoTrader(context),
+      mUnhedgedTimer(
+          WheelTimer::Calling<&AutoTrader::UnhedgedTimerHandler>(this)) {
+  mParameters.Staging().Derive();
+  mParameters.Publish();
+}
+
+void AutoTrader::LoadParameters(const boost::property_tree::ptree& tree) {
+  auto& next = mParameters.Staging();
+  // Absent values are kept, malformed ones are rejected
+  auto read = [](const boost::property_tree::ptree& section, const char* name,
+                 auto& value) {
+    if (section.count(name) != 0) {
+      value = section.get<std::remove_reference_t<decltype(value)>>(name);
+    }
+  };
+
+  try {
+    if (auto section = tree.get_child_optional("Parameters")) {
+      read(*section, "LotSize", next.lotSize);
+      read(*section, "PositionLimit", next.positionLimit);
+      read(*section, "TickSizeInCents", next.tickSizeInCents);
+      read(*section, "EtfClamp", next.etfClamp);
+      read(*section, "LadderLevels", next.ladderLevels);
+      read(*section, "LadderSpacing", next.ladderSpacing);
+      read(*section, "LadderVolumeIncrement", next.ladderVolumeIncrement);
+      read(*section, "TakerVolume", next.takerVolume);
+      read(*section, "TakerEdgeTicks", next.takerEdgeTicks);
+      read(*section, "TakerSkewTicks", next.takerSkewTicks);
+      read(*section, "UnhedgedMarginSeconds", next.unhedgedMarginSeconds);
+      read(*section, "MaxOrderAgeTicks", next.maxOrderAgeTicks);
+      read(*section, "MaxQuoteDistanceTicks", next.maxQuoteDistanceTicks);
+      read(*section, "AdaptiveLotSize", next.adaptiveLotSize);
+      read(*section, "MinLotSize", next.minLotSize);
+      read(*section, "MaxLotSize", next.maxLotSize);
+      read(*section, "DepthFraction", next.depthFraction);
+      read(*section, "FillRateHalfLifeTicks", next.fillRateHalfLifeTicks);
+      read(*section, "TargetFillRate", next.targetFillRate);
+      std::string policy;
+      read(*section, "PricingPolicy", policy);
+      if (policy == "touch") {
+        next.pricingPolicy = PricingPolicy::TOUCH;
+      } else if (policy == "inventory") {
+        next.pricingPolicy = PricingPolicy::INVENTORY;
+      } else if (!policy.empty()) {
+        throw ReadyTraderGoError(
+            "invalid parameters: PricingPolicy must be \"touch\" or "
+            "\"inventory\"");
+      }
+      read(*section, "RiskAversion", next.riskAversion);
+      read(*section, "HorizonTicks", next.horizonTicks);
+      read(*section, "VolatilityHalfLifeTicks", next.volatilityHalfLifeTicks);
+      read(*section, "IntensityHalfLife", next.intensityHalfLife);
+    }
+  } catch (const boost::property_tree::ptree_error& e) {
+    throw ReadyTraderGoError(std::string("invalid parameters: ") + e.what());
+  }
+
+  if (next.lotSize == 0 || next.positionLimit <= 0 ||
+      next.tickSizeInCents == 0) {
+    throw ReadyTraderGoError("invalid parameters: values must be positive");
+  }
+  if (!(next.etfClamp >= 0.0 && next.etfClamp < 1.0)) {
+    throw ReadyTraderGoError("invalid parameters: EtfClamp must be in [0, 1)");
+  }
+  if (next.ladderLevels == 0 || next.ladderLevels > MAX_QUOTE_LEVELS ||
+      next.ladderLevels * 2 > ACTIVE_ORDER_COUNT_LIMIT ||
+      next.ladderSpacing == 0) {
+    throw ReadyTraderGoError(
+        "invalid parameters: LadderLevels must be 1 to " +
+        std::to_string(MAX_QUOTE_LEVELS) + " and LadderSpacing positive");
+  }
+  if (next.takerEdgeTicks < 0 || next.takerSkewTicks < 0) {
+    throw ReadyTraderGoError(
+        "invalid parameters: TakerEdgeTicks and TakerSkewTicks must not be "
+        "negative");
+  }
+  if (!(next.unhedgedMarginSeconds >= 0.0 &&
+        next.unhedgedMarginSeconds < UNHEDGED_LOTS_TIME_LIMIT)) {
+    throw ReadyTraderGoError(
+        "invalid parameters: UnhedgedMarginSeconds must be less than the "
+        "unhedged lots time limit");
+  }
+  if (next.minLotSize == 0 || next.maxLotSize < next.minLotSize ||
+      !(next.depthFraction >= 0.0) || !(next.fillRateHalfLifeTicks > 0.0) ||
+      !(next.targetFillRate > 0.0)) {
+    throw ReadyTraderGoError(
+        "invalid parameters: MinLotSize must be positive and at most "
+        "MaxLotSize, DepthFraction not negative, and FillRateHalfLifeTicks "
+        "and TargetFillRate positive");
+  }
+  if (!(next.riskAversion >= 0.0) || !(next.horizonTicks >= 0.0) ||
+      !(next.volatilityHalfLifeTicks > 0.0) ||
+      !(next.intensityHalfLife > 0.0)) {
+    throw ReadyTraderGoError(
+        "invalid parameters: RiskAversion and HorizonTicks must not be "
+        "negative, and VolatilityHalfLifeTicks and IntensityHalfLife must be "
+        "positive");
+  }
+  next.Derive();
+  if (next.ladderTotalVolume * 2 > ACTIVE_VOLUME_LIMIT) {
+    throw ReadyTraderGoError(
+        "invalid parameters: ladders would exceed the active volume limit");
+  }
+  mParameters.Publish();
+  mFairValue.Configure(next.etfClamp, next.tickSizeInCents);
+  mLotSizer.Configure({next.lotSize, next.minLotSize, next.maxLotSize,
+                       next.positionLimit, next.depthFraction,
+                       next.fillRateHalfLifeTicks, next.targetFillRate});
+  mInventoryQuoter.Configure({next.riskAversion, next.horizonTicks,
+                              next.volatilityHalfLifeTicks,
+                              next.intensityHalfLife});
+
+  RLOG(LG_AT, LogLevel::LL_INFO)
+      << "[LoadParameters] "
+      << "(lotSize " << next.lotSize << ")"
+      << "(positionLimit " << next.positionLimit << ")"
+      << "(tickSizeInCents " << next.tickSizeInCents << ")"
+      << "(etfClamp " << next.etfClamp << ")"
+      << "(ladder " << next.ladderLevels << " levels, spacing "
+      << next.ladderSpacing << ", increment " << next.ladderVolumeIncrement
+      << ")"
+      << "(taker " << next.takerVolume << " lots, edge " << next.takerEdgeTicks
+      << " skew " << next.takerSkewTicks << " ticks)"
+      << "(unhedgedMarginSeconds " << next.unhedgedMarginSeconds << ")"
+      << "(max order age " << next.maxOrderAgeTicks << " ticks, quote "
+      << "distance " << next.maxQuoteDistanceTicks << " ticks)"
+      << "(adaptive lot size " << next.adaptiveLotSize << ": " << next.minLotSize
+      << " to " << next.maxLotSize << ", depth fraction " << next.depthFraction
+      << ", fill rate half-life " << next.fillRateHalfLifeTicks
+      << " ticks, target " << next.targetFillRate << ")"
+      << "(pricing "
+      << (next.pricingPolicy == PricingPolicy::INVENTORY ? "inventory"
+                                                         : "touch")
+      << ": risk aversion " << next.riskAversion << ", horizon "
+      << next.horizonTicks << " ticks, half-lives "
+      << next.volatilityHalfLifeTicks << " ticks and "
+      << next.intensityHalfLife << " trade ticks)";
+}
 
 void AutoTrader::DisconnectHandler() {
   BaseAutoTrader::DisconnectHandler();
   RLOG(LG_AT, LogLevel::LL_INFO) << "execution connection lost";
 }
 
+void AutoTrader::ReconnectedHandler() {
+  RLOG(LG_AT, LogLevel::LL_INFO)
+      << "[ReconnectedHandler] "
+      << "(marking " << mOrderBook.size() << " orders unknown)";
+
+  for (auto& [id, order] : mOrderBook) {
+    order.unknown = true;
+  }
+  mResyncTick = mTicks;
+  mResyncing = !mOrderBook.empty();
+  mQuotesDirty = true;
+}
+
 void AutoTrader::ErrorMessageHandler(unsigned long clientOrderId,
-                                     const std::string& errorMessage) {
+                                     std::string_view errorMessage) {
   auto it = mOrderBook.find(clientOrderId);
   if (it != mOrderBook.end()) {
     // Found order
+    auto& order = it->second;
     RLOG(LG_AT, LogLevel::LL_ERROR)
-        << "[ErrorMessageHandler] " << OrderInformation::ToString(it->second)
+        << "[ErrorMessageHandler] " << OrderInformation::ToString(order)
         << "(Error " << errorMessage << " )";
+    if (ApplyOrderEvent(order, OrderEvent::REJECTED) == OrderState::DONE) {
+      // A rejected hedge is retried like an unsuccessful one
+      mQuotesDirty |= order.lifespan == Lifespan::GOOD_FOR_DAY;
+      EraseOrder(it);
+    }
   } else {
     // Unfound order
     RLOG(LG_AT, LogLevel::LL_ERROR)
@@ -69,6 +250,21 @@ void AutoTrader::SendInsertOrder(unsigned long clientOrderId,
                                  ReadyTraderGo::Lifespan lifespan) {
   if (price == 0 || volume == 0) return;
 
+  // The exchange rejects an order that would trade with one of our own
+  if (mOwnPrices.WouldCross(side, price)) {
+    ++mSelfTradesPrevented;
+    mQuotesDirty = true;
+    RLOG(LG_AT, ReadyTraderGo::LogLevel::LL_WARNING)
+        << "[SendInsertOrder] "
+        << "(would cross our own orders, not sent) "
+        << "(side " << Utilities::SideToString(side) << ")"
+        << "(price " << price << ")"
+        << "(own bid " << mOwnPrices.BestBid() << " ask "
+        << mOwnPrices.BestAsk() << ")"
+        << "(prevented " << mSelfTradesPrevented << ")";
+    return;
+  }
+
   RLOG(LG_AT, ReadyTraderGo::LogLevel::LL_INFO)
       << "[SendInsertOrder] "
       << "(clientOrderId " << clientOrderId << ")"
@@ -77,11 +273,25 @@ void AutoTrader::SendInsertOrder(unsigned long clientOrderId,
       << "(volume " << volume << ")"
       << "(lifespan " << Utilities::LifespanToString(lifespan) << ")";
 
-  // Record order
-  mOrderBook[clientOrderId] = {mTicks, clientOrderId, side,           price,
-                               volume, lifespan,      Instrument::ETF};
+  // Record order, with everything already at its price queued ahead of it
+  auto& order = mOrderBook[clientOrderId];
+  order = {mTicks, clientOrderId, side,           price,
+           volume, lifespan,      Instrument::ETF};
+  order.sentAt = LatencyHistogram::Clock::now();
+  TrackETFOrder(order);
+  const auto& book = mBooks[static_cast<int>(Instrument::ETF)];
+  order.queue = QueuePosition(
+      side, price,
+      side == Side::SELL
+          ? VolumeAtPrice(book.GetAskPrices(), book.GetAskVolumes(), price)
+          : VolumeAtPrice(book.GetBidPrices(), book.GetBidVolumes(), price));
+  if (lifespan == Lifespan::GOOD_FOR_DAY) {
+    mOrderAges.PushBack(order, order.age);
+    mOwnPrices.Add(order.ownPrice, side, price);
+  }
 
   // Call super
+  CountMessage();
   BaseAutoTrader::SendInsertOrder(clientOrderId, side, price, volume, lifespan);
 }
 
@@ -103,7 +313,9 @@ void AutoTrader::SendHedgeOrder(unsigned long clientOrderId,
                                volume,
                                Lifespan::GOOD_FOR_DAY,
                                Instrument::FUTURE};
+  (side == Side::BUY ? mHedgeBuyInFlight : mHedgeSellInFlight) += long(volume);
 
+  CountMessage();
   BaseAutoTrader::SendHedgeOrder(clientOrderId, side, price, volume);
 }
 
@@ -116,9 +328,13 @@ inline void AutoTrader::SendAmendOrder(unsigned long clientOrderId,
 
   auto it = mOrderBook.find(clientOrderId);
   if (it != mOrderBook.end()) {
+    CountMessage();
     BaseAutoTrader::SendAmendOrder(clientOrderId, volume);
-    // Update
-    it->second.volume = volume;
+    // The exchange takes the new total volume, which includes what has
+    // already been filled
+    const auto filled = it->second.filledVolume;
+    SetOrderVolume(it->second, volume > filled ? volume - filled : 0);
+    ApplyOrderEvent(it->second, OrderEvent::AMEND_SENT);
   } else {
     RLOG(LG_AT, ReadyTraderGo::LogLevel::LL_ERROR)
         << "[SendAmendOrder] "
@@ -170,11 +386,17 @@ inline void AutoTrader::SendCancelOrder(unsigned long clientOrderId) {
 
   auto it = mOrderBook.find(clientOrderId);
   if (it != mOrderBook.end()) {
-    // Clear record of order
-    mOrderBook.erase(it);
+    if (it->second.state == OrderState::PENDING_CANCEL) {
+      return;
+    }
 
-    // Send cancel order
+    // Send cancel order. The order is kept until the exchange closes it, so
+    // that fills on the way are still hedged, but is no longer quoted
+    CountMessage();
     BaseAutoTrader::SendCancelOrder(clientOrderId);
+    ApplyOrderEvent(it->second, OrderEvent::CANCEL_SENT);
+    it->second.age.Unlink();
+    it->second.ownPrice.Release();
 
   } else {
     RLOG(LG_AT, ReadyTraderGo::LogLevel::LL_ERROR)
@@ -185,6 +407,15 @@ inline void AutoTrader::SendCancelOrder(unsigned long clientOrderId) {
 
 /*** ----------------------- ***/
 
+const QueuePosition* AutoTrader::GetQueuePosition(
+    unsigned long clientOrderId) const {
+  auto it = mOrderBook.find(clientOrderId);
+  if (it == mOrderBook.end() || it->second.instrument != Instrument::ETF) {
+    return nullptr;
+  }
+  return &it->second.queue;
+}
+
 void AutoTrader::HedgeFilledMessageHandler(unsigned long clientOrderId,
                                            unsigned long price,
                                            unsigned long volume) {
@@ -203,32 +434,139 @@ void AutoTrader::HedgeFilledMessageHandler(unsigned long clientOrderId,
   }
 
   auto& order = it->second;
+  const long sign = order.side == Side::BUY ? 1 : -1;
 
   if (!price && !volume) {
-    // unsuccessful hedge
-    // just re-do the hedge
-    RLOG(LG_AT, LogLevel::LL_ERROR) << "[HedgeFilledMessageHandler] "
-                                    << "(unsuccessful hedge, redoing) "
-                                    << OrderInformation::ToString(order);
-
-    if (order.side == Side::BUY) {
-      order.price += TICK_SIZE_IN_CENTS;
-    }
-    else {
-      order.price -= TICK_SIZE_IN_CENTS;
-    }
-    SendHedgeOrder(order);
+    // Unsuccessful: there was nothing to hedge against at the price. Retry
+    // with the next future order book rather than straight away, which
+    // could spin for as long as the book stays out of reach
+    RLOG(LG_AT, LogLevel::LL_WARNING) << "[HedgeFilledMessageHandler] "
+                                      << "(unsuccessful hedge, retrying) "
+                                      << OrderInformation::ToString(order);
+    EraseOrder(it);
   } else {
     // Succesful hedge, handle partial
     // Once fully clear, remove from internal order book
-    order.volume -= volume;
+    mFUTPosition += sign * long(volume);
+    const auto filled = std::min(order.volume, volume);
+    (order.side == Side::BUY ? mHedgeBuyInFlight : mHedgeSellInFlight) -=
+        long(filled);
+    order.volume -= filled;
     if (order.volume == 0) {
       RLOG(LG_AT, LogLevel::LL_INFO)
           << "[HedgeFilledMessageHandler] "
           << "(Order fully filled, clearing from internal order book)";
-      mOrderBook.erase(it);
+      EraseOrder(it);
+    }
+    ApplyPositionDelta(sign * long(volume));
+  }
+}
+
+void AutoTrader::ApplyPositionDelta(long delta) {
+  const bool hadDeadline = mUnhedgedLots.HasDeadline();
+  const double previousDeadline = mUnhedgedLots.GetDeadline();
+  mUnhedgedLots.ApplyPositionDelta(timerNow(mTimers), delta);
+
+  if (!mUnhedgedLots.HasDeadline()) {
+    if (hadDeadline) {
+      RLOG(LG_AT, LogLevel::LL_INFO)
+          << "[ApplyPositionDelta] "
+          << "(unhedged lots back within the limit) (relative position "
+          << mUnhedgedLots.GetRelativePosition() << ")";
+      mTimers.Cancel(mUnhedgedTimer);
+      mHedgeEscalation = 0;
     }
+    return;
+  }
+  if (hadDeadline && mUnhedgedLots.GetDeadline() == previousDeadline) {
+    return;
+  }
+
+  const double fireAt = mUnhedgedLots.GetDeadline() -
+                        mParameters.Get().unhedgedMarginSeconds;
+  mTimers.Schedule(
+      mUnhedgedTimer,
+      TimerService::Clock::time_point(
+          std::chrono::duration_cast<TimerService::Clock::duration>(
+              std::chrono::duration<double>(fireAt))));
+  mHedgeEscalation = 0;
+
+  RLOG(LG_AT, LogLevel::LL_INFO)
+      << "[ApplyPositionDelta] "
+      << "(unhedged lots " << mUnhedgedLots.GetUnhedgedLotCount() << ") "
+      << "(relative position " << mUnhedgedLots.GetRelativePosition() << ")";
+}
+
+void AutoTrader::UnhedgedTimerHandler() {
+  if (!mUnhedgedLots.HasDeadline()) {
+    return;
+  }
+
+  // Hedge everything that is not already on its way to being hedged
+  ++mHedgeEscalation;
+  ++mHedgeEscalations;
+  RLOG(LG_AT, LogLevel::LL_WARNING)
+      << "[UnhedgedTimerHandler] "
+      << "(unhedged lots " << mUnhedgedLots.GetUnhedgedLotCount() << ") "
+      << "(outstanding " << UnhedgedFutureLots() << ") "
+      << "(escalation " << mHedgeEscalation << ")";
+  if (IsExecutionConnected()) {
+    HedgeOutstanding();
+  }
+
+  mTimers.ScheduleAfter(mUnhedgedTimer, HEDGE_ESCALATION_INTERVAL);
+}
+
+unsigned long AutoTrader::HedgePrice(Side side, unsigned long escalation) const {
+  const auto& parameters = mParameters.Get();
+  if (escalation >= HEDGE_ESCALATION_LEVELS) {
+    return side == Side::BUY ? parameters.maxAskNearestTick
+                             : parameters.minBidNearestTick;
+  }
+
+  const auto& future = mBooks[static_cast<int>(Instrument::FUTURE)];
+  const ulong offset = escalation * parameters.tickSizeInCents;
+  if (side == Side::BUY) {
+    const ulong best = future.BestAsk();
+    return best == 0 ? 0 : std::min(best + offset, parameters.maxAskNearestTick);
+  }
+  const ulong best = future.BestBid();
+  if (best == 0) {
+    return 0;
+  }
+  return best >= parameters.minBidNearestTick + offset
+             ? best - offset
+             : parameters.minBidNearestTick;
+}
+
+void AutoTrader::HedgeOutstanding(Side side, unsigned long price) {
+  const long lots = UnhedgedFutureLots();
+  if (lots == 0) {
+    return;
+  }
+  const Side hedgeSide = lots > 0 ? Side::BUY : Side::SELL;
+  if (hedgeSide != side || price == 0) {
+    price = HedgePrice(hedgeSide, mHedgeEscalation);
+  }
+
+  // Assume every hedge in flight on this side will be filled
+  const long limit = mParameters.Get().positionLimit;
+  const long room = hedgeSide == Side::BUY
+                        ? limit - (mFUTPosition + mHedgeBuyInFlight)
+                        : limit + (mFUTPosition - mHedgeSellInFlight);
+  const ulong volume = ulong(std::min(std::labs(lots), std::max(0L, room)));
+  if (volume < ulong(std::labs(lots))) {
+    RLOG(LG_AT, LogLevel::LL_WARNING)
+        << "[HedgeOutstanding] "
+        << "(held back by the position limit) "
+        << "(outstanding " << lots << ") "
+        << "(future position " << mFUTPosition << ", in flight +"
+        << mHedgeBuyInFlight << "/-" << mHedgeSellInFlight << ")";
   }
+  if (price == 0 || volume == 0) {
+    return;
+  }
+  SendHedgeOrder(hedgeSide, price, volume);
 }
 
 void AutoTrader::OrderBookMessageHandler(
@@ -237,6 +575,34 @@ void AutoTrader::OrderBookMessageHandler(
     const std::array<unsigned long, TOP_LEVEL_COUNT>& askVolumes,
     const std::array<unsigned long, TOP_LEVEL_COUNT>& bidPrices,
     const std::array<unsigned long, TOP_LEVEL_COUNT>& bidVolumes) {
+  const auto received = LatencyHistogram::Clock::now();
+  auto& book = mBooks[static_cast<int>(instrument)];
+  if (!book.Update(sequenceNumber, askPrices, askVolumes, bidPrices,
+                   bidVolumes)) {
+    RLOG(LG_AT, LogLevel::LL_WARNING)
+        << "[OrderBookMessageHandler] "
+        << "(ignoring stale snapshot) (seq " << sequenceNumber << ")";
+    return;
+  }
+  const bool fairValueChanged = mFairValue.OnOrderBook(instrument, book);
+
+  // Before anything else, trade against ETF prices the fair value has left
+  // behind
+  if (IsExecutionConnected()) {
+    TakeStalePrices(Side::BUY, received);
+    TakeStalePrices(Side::SELL, received);
+  }
+
+  const auto& delta = book.GetDelta();
+
+  if (instrument == Instrument::ETF) {
+    for (auto& [id, order] : mOrderBook) {
+      if (order.instrument == Instrument::ETF && !order.unknown) {
+        order.queue.OnOrderBook(book, order.volume);
+      }
+    }
+  }
+
   // Log the message handler
   std::stringstream ss;
   for (ulong i = 0; i < TOP_LEVEL_COUNT; ++i) {
@@ -248,52 +614,381 @@ void AutoTrader::OrderBookMessageHandler(
       << "[OrderBookMessageHandler] "
       << " (ticks " << mTicks << ") "
       << " (seq " << sequenceNumber << ") "
+      << "(changed bid " << delta.mBid.mChangedLevels << " ask "
+      << delta.mAsk.mChangedLevels << ") "
+      << "(depth bid " << delta.mBid.TotalVolume() << " ask "
+      << delta.mAsk.TotalVolume() << ") "
+      << "(imbalance " << delta.mImbalance << ") "
+      << "(weighted mid " << delta.mWeightedMid << ") "
+      << "(fair value " << mFairValue.GetTheoreticalPrice() << " ["
+      << mFairValue.GetLowerBound() << "," << mFairValue.GetUpperBound()
+      << "]) "
       << Utilities::InstrumentToString(instrument) << " " << ss.str();
 
-  // Stay top of the book
-  ulong bestBid = bidPrices[0];
-  ulong bestAsk = askPrices[0];
-  ulong bestPrice;
-
   if (instrument == Instrument::FUTURE) {
+    if (UnhedgedFutureLots() != 0 && IsExecutionConnected()) {
+      HedgeOutstanding();
+    }
+    // The ETF quotes follow the future's fair value
+    if (fairValueChanged && IsExecutionConnected()) {
+      UpdateQuotes();
+    }
     return;
   }
 
-  // Get orderbook keys
-  ulong instrumentOrders = 0;
-  std::vector<ulong> orderIds(mOrderBook.size());
-  for (auto [id, order] : mOrderBook) {
-    orderIds.push_back(id);
+  if (!IsExecutionConnected()) {
+    return;
+  }
 
-    // Count how many orders are of this instrument we are in
-    if (order.instrument == instrument) {
-      ++instrumentOrders;
+  if (mResyncing && mTicks - mResyncTick >= RESYNC_TICKS) {
+    // Anything the exchange has not reported on since the reconnection is
+    // no longer live
+    for (auto it = mOrderBook.begin(); it != mOrderBook.end();) {
+      if (it->second.unknown) {
+        RLOG(LG_AT, LogLevel::LL_WARNING)
+            << "[OrderBookMessageHandler] "
+            << "(forgetting unconfirmed order) "
+            << OrderInformation::ToString(it->second);
+        it = EraseOrder(it);
+        mQuotesDirty = true;
+      } else {
+        ++it;
+      }
     }
+    mResyncing = false;
+  }
+
+  SweepStaleOrders();
+  UpdateQuotes();
+
+  mLotSizer.OnTick();
+  mInventoryQuoter.OnTick(mFairValue.GetRawTheoreticalPrice());
+  ++mTicks;
+}
+
+void AutoTrader::TakeStalePrices(Side side,
+                                 LatencyHistogram::Clock::time_point received) {
+  const auto& parameters = mParameters.Get();
+  const auto& etf = mBooks[static_cast<int>(Instrument::ETF)];
+  const auto sequenceNumber = etf.GetSequenceNumber();
+  auto& takenSequence = mTakenSequence[static_cast<int>(side)];
+  if (parameters.takerVolume == 0 || !mFairValue.IsValid() ||
+      takenSequence == sequenceNumber) {
+    return;
   }
 
-  // Re-price all orders on the book, currently in the book
-  for (auto& id : orderIds) {
-    // (id, order) iterator
-    if (mOrderBook[id].instrument == instrument) {
-      // Only edit price if this is the right instrument
-      bestPrice = mOrderBook[id].side == Side::BUY ? bestBid : bestAsk;
-      SendAmendOrderExtended(id, bestPrice);
+  // Buy below, or sell above, the fair value by at least the edge for our
+  // current position
+  const auto bucket = parameters.TakerBucket(mETFPosition);
+  const long theoreticalPrice = long(mFairValue.GetTheoreticalPrice());
+  const bool buy = side == Side::BUY;
+  const long limit = buy ? theoreticalPrice - parameters.takerBuyEdge[bucket]
+                         : theoreticalPrice + parameters.takerSellEdge[bucket];
+  const auto& prices = buy ? etf.GetAskPrices() : etf.GetBidPrices();
+  const auto& volumes = buy ? etf.GetAskVolumes() : etf.GetBidVolumes();
+  if (prices[0] == 0 || (buy ? long(prices[0]) > limit
+                             : long(prices[0]) < limit)) {
+    return;
+  }
+
+  // Our own orders limit how much we may trade and at what price
+  const ulong activeVolume = mETFOrderVolume;
+  const ulong sameSideVolume = mETFSideVolume[static_cast<int>(side)];
+  const ulong ownAsk = mOwnPrices.BestAsk();
+  const ulong crossPrice =
+      buy ? (ownAsk == 0 ? MAXIMUM_ASK : ownAsk) : mOwnPrices.BestBid();
+  const long position = buy ? mETFPosition : -mETFPosition;
+  const long room = parameters.positionLimit - position - long(sameSideVolume);
+  if (mETFOrderCount >= ACTIVE_ORDER_COUNT_LIMIT || room <= 0 ||
+      activeVolume >= ACTIVE_VOLUME_LIMIT) {
+    return;
+  }
+  ulong maxVolume = std::min<ulong>(parameters.takerVolume, ulong(room));
+  maxVolume = std::min(maxVolume, ACTIVE_VOLUME_LIMIT - activeVolume);
+
+  // Sweep the levels inside the limit, stopping short of our own orders
+  ulong price = 0;
+  ulong volume = 0;
+  for (std::size_t i = 0; i < TOP_LEVEL_COUNT && prices[i] != 0; ++i) {
+    const bool inside = buy ? long(prices[i]) <= limit && prices[i] < crossPrice
+                            : long(prices[i]) >= limit && prices[i] > crossPrice;
+    if (!inside || volume >= maxVolume) {
+      break;
     }
+    price = prices[i];
+    volume = std::min(maxVolume, volume + volumes[i]);
+  }
+  if (volume == 0 || DiscretionaryMessagesAvailable() == 0) {
+    return;
   }
 
-  if (instrumentOrders == 0) {
-    // If no orders on book, create 2
-    SendInsertOrder(Side::BUY, bestBid, 10, Lifespan::GOOD_FOR_DAY);
-    SendInsertOrder(Side::SELL, bestAsk, 10, Lifespan::GOOD_FOR_DAY);
-  } else if (instrumentOrders == 1) {
-    // If there is one order on the book
-    // Re-price it and insert opposite side
-    auto& order = mOrderBook.begin()->second;
-    bestPrice = (!order.side) == Side::BUY ? bestBid : bestAsk;
-    SendInsertOrder(!order.side, bestPrice, 10, Lifespan::GOOD_FOR_DAY);
+  takenSequence = sequenceNumber;
+  const auto clientOrderId = ++mOrderId;
+  CountMessage();
+  BaseAutoTrader::SendInsertOrder(clientOrderId, side, price, volume,
+                                  Lifespan::FILL_AND_KILL);
+  mTakerLatency.Record(received, LatencyHistogram::Clock::now());
+
+  auto& order = mOrderBook[clientOrderId];
+  order = {mTicks, clientOrderId, side, price, volume, Lifespan::FILL_AND_KILL,
+           Instrument::ETF};
+  order.sentAt = LatencyHistogram::Clock::now();
+  TrackETFOrder(order);
+
+  RLOG(LG_AT, LogLevel::LL_INFO)
+      << "[TakeStalePrices] "
+      << "(clientOrderId " << clientOrderId << ")"
+      << "(side " << Utilities::SideToString(side) << ")"
+      << "(price " << price << ")"
+      << "(volume " << volume << ")"
+      << "(fair value " << theoreticalPrice << ")"
+      << "(latency p50 " << mTakerLatency.Percentile(0.5) << "ns max "
+      << mTakerLatency.Max() << "ns over " << mTakerLatency.Count() << ")";
+}
+
+std::size_t AutoTrader::DiscretionaryMessagesAvailable() {
+  return mMessageBudget.Available(mTimers.Now(), DISCRETIONARY_MESSAGE_LIMIT);
+}
+
+void AutoTrader::SweepStaleOrders() {
+  const auto maxAge = mParameters.Get().maxOrderAgeTicks;
+  if (maxAge == 0) {
+    return;
+  }
+  while (auto* order = mOrderAges.Front()) {
+    // The rest are swept on a later tick
+    if (mTicks - order->tick < maxAge || DiscretionaryMessagesAvailable() == 0) {
+      return;
+    }
+    RLOG(LG_AT, LogLevel::LL_INFO) << "[SweepStaleOrders] "
+                                   << OrderInformation::ToString(*order);
+    order->age.Unlink();
+    mQuotesDirty = true;
+    SendCancelOrder(order->id);
   }
+}
 
-  ++mTicks;
+void AutoTrader::SizeLadder(Side side, unsigned long touchVolume,
+                            std::array<ulong, MAX_QUOTE_LEVELS>& volumes) const {
+  const auto& parameters = mParameters.Get();
+  ulong budget = ACTIVE_VOLUME_LIMIT / 2;
+  const ulong nearest = mLotSizer.Size(side, mETFPosition, touchVolume);
+  for (ulong i = 0; i < volumes.size(); ++i) {
+    const ulong volume =
+        i < parameters.ladderLevels && nearest != 0
+            ? std::min(budget, nearest + i * parameters.ladderVolumeIncrement)
+            : 0;
+    volumes[i] = volume;
+    budget -= volume;
+  }
+}
+
+void AutoTrader::CapLadder(Side side, unsigned long unquotedVolume,
+                           std::array<ulong, MAX_QUOTE_LEVELS>& volumes) const {
+  const long exposure = side == Side::BUY ? mETFPosition : -mETFPosition;
+  ulong room = ulong(std::max(
+      0L, mParameters.Get().positionLimit - exposure - long(unquotedVolume)));
+  for (auto& volume : volumes) {
+    volume = std::min(volume, room);
+    room -= volume;
+  }
+}
+
+std::array<long, 2> AutoTrader::PositionRoom() const {
+  const long limit = mParameters.Get().positionLimit;
+  std::array<long, 2> room{};
+  room[static_cast<int>(Side::BUY)] =
+      limit - mETFPosition - long(mETFSideVolume[static_cast<int>(Side::BUY)]);
+  room[static_cast<int>(Side::SELL)] =
+      limit + mETFPosition - long(mETFSideVolume[static_cast<int>(Side::SELL)]);
+  return room;
+}
+
+void AutoTrader::UpdateQuotes() {
+  const auto& parameters = mParameters.Get();
+  const auto& book = mBooks[static_cast<int>(Instrument::ETF)];
+
+  // Stay top of the book, or quote around the reservation price without
+  // crossing the spread, but never bid above or offer below the prices at
+  // which the exchange would value the ETF
+  ulong bestBid = book.BestBid();
+  ulong bestAsk = book.BestAsk();
+  if (parameters.pricingPolicy == PricingPolicy::INVENTORY &&
+      mFairValue.IsValid() && mInventoryQuoter.IsValid()) {
+    const double tick = double(parameters.tickSizeInCents);
+    const double mid = mFairValue.GetRawTheoreticalPrice();
+    const double bid =
+        std::floor(mInventoryQuoter.GetBidPrice(mid, mETFPosition) / tick);
+    const double ask =
+        std::ceil(mInventoryQuoter.GetAskPrice(mid, mETFPosition) / tick);
+    bestBid = bid > 0.0 ? ulong(bid) * parameters.tickSizeInCents : 0;
+    bestAsk = ask > 0.0 && ask * tick <= double(MAXIMUM_ASK)
+                  ? ulong(ask) * parameters.tickSizeInCents
+                  : 0;
+    if (book.BestAsk() != 0 && bestBid >= book.BestAsk()) {
+      bestBid = book.BestAsk() - parameters.tickSizeInCents;
+    }
+    if (bestAsk != 0 && bestAsk <= book.BestBid()) {
+      bestAsk = book.BestBid() + parameters.tickSizeInCents;
+    }
+  }
+  if (mFairValue.IsValid()) {
+    bestBid = std::min(bestBid, mFairValue.GetMaxBidPrice());
+    bestAsk = std::max(bestAsk, mFairValue.GetMinAskPrice());
+  }
+  // Quoting both sides of a locked (or crossed) market would trade with
+  // ourselves, so stand aside until it opens up
+  if (bestBid != 0 && bestAsk != 0 && bestBid >= bestAsk) {
+    bestBid = bestAsk = 0;
+  }
+
+  // Ladders step away from the best prices, as far as valid prices go and
+  // no further behind the touch than the maximum distance
+  QuoteLevels bids{};
+  QuoteLevels asks{};
+  const ulong spacing = parameters.ladderSpacing * parameters.tickSizeInCents;
+  const ulong maxDistance =
+      parameters.maxQuoteDistanceTicks == 0
+          ? MAXIMUM_ASK
+          : parameters.maxQuoteDistanceTicks * parameters.tickSizeInCents;
+  const ulong lowestBid =
+      book.BestBid() > maxDistance ? book.BestBid() - maxDistance : 0;
+  const ulong highestAsk =
+      book.BestAsk() == 0 ? MAXIMUM_ASK : book.BestAsk() + maxDistance;
+  auto bidVolumes = parameters.ladderVolumes;
+  auto askVolumes = parameters.ladderVolumes;
+  if (parameters.adaptiveLotSize) {
+    SizeLadder(Side::BUY, book.GetBidVolumes()[0], bidVolumes);
+    SizeLadder(Side::SELL, book.GetAskVolumes()[0], askVolumes);
+  }
+  // Orders being cancelled and fill-and-kill orders may still trade, but
+  // are not part of the ladders
+  std::array<ulong, 2> unquoted{};
+  for (const auto& [id, order] : mOrderBook) {
+    if (order.instrument == Instrument::ETF &&
+        (order.lifespan == Lifespan::FILL_AND_KILL ||
+         order.state == OrderState::PENDING_CANCEL)) {
+      unquoted[static_cast<int>(order.side)] += order.volume;
+    }
+  }
+  CapLadder(Side::BUY, unquoted[static_cast<int>(Side::BUY)], bidVolumes);
+  CapLadder(Side::SELL, unquoted[static_cast<int>(Side::SELL)], askVolumes);
+  for (ulong i = 0; i < parameters.ladderLevels; ++i) {
+    const ulong offset = i * spacing;
+    if (bestBid != 0 && bestBid >= parameters.minBidNearestTick + offset &&
+        bestBid - offset >= lowestBid && bidVolumes[i] != 0) {
+      bids[i] = {bestBid - offset, bidVolumes[i]};
+    }
+    if (bestAsk != 0 && bestAsk + offset <= parameters.maxAskNearestTick &&
+        bestAsk + offset <= highestAsk && askVolumes[i] != 0) {
+      asks[i] = {bestAsk + offset, askVolumes[i]};
+    }
+  }
+
+  // Nothing to do if neither the targets nor our orders have changed
+  if (!mQuotesDirty && bids == mQuotedBids && asks == mQuotedAsks) {
+    return;
+  }
+  mQuotesDirty = false;
+  mQuotedBids = bids;
+  mQuotedAsks = asks;
+
+  // Client order ids increase, so sorting by id puts the oldest first
+  std::array<LiveQuote, MAX_LIVE_QUOTES> liveBids;
+  std::array<LiveQuote, MAX_LIVE_QUOTES> liveAsks;
+  std::size_t liveBidCount = 0;
+  std::size_t liveAskCount = 0;
+  for (auto& [id, order] : mOrderBook) {
+    if (order.instrument != Instrument::ETF ||
+        order.lifespan != Lifespan::GOOD_FOR_DAY ||
+        order.state == OrderState::PENDING_CANCEL) {
+      continue;
+    }
+    if (order.side == Side::BUY && liveBidCount < liveBids.size()) {
+      liveBids[liveBidCount++] = {id, order.price, order.volume};
+    } else if (order.side == Side::SELL && liveAskCount < liveAsks.size()) {
+      liveAsks[liveAskCount++] = {id, order.price, order.volume};
+    }
+  }
+  auto byId = [](const LiveQuote& a, const LiveQuote& b) {
+    return a.mClientOrderId < b.mClientOrderId;
+  };
+  std::sort(liveBids.begin(), liveBids.begin() + liveBidCount, byId);
+  std::sort(liveAsks.begin(), liveAsks.begin() + liveAskCount, byId);
+
+  QuoteDiffer::Actions bidActions;
+  QuoteDiffer::Actions askActions;
+  constexpr std::size_t maxOrdersPerSide = ACTIVE_ORDER_COUNT_LIMIT / 2;
+  const auto bidActionCount = mQuoteDiffer.Diff(
+      bids, liveBids.data(), liveBidCount, bidActions, maxOrdersPerSide);
+  const bool bidsCovered = mQuoteDiffer.IsCovered();
+  const auto askActionCount = mQuoteDiffer.Diff(
+      asks, liveAsks.data(), liveAskCount, askActions, maxOrdersPerSide);
+  // A level left short for want of an order slot is tried again next update
+  mQuotesDirty = !bidsCovered || !mQuoteDiffer.IsCovered();
+
+  // Take volume off the market on both sides before adding any. Orders just
+  // cancelled may still trade, so an insert that would leave too little
+  // room for them is cut, and made up once the exchange has closed them.
+  // Whatever the message budget does not cover waits for the next update,
+  // so inserts are the first to wait.
+  std::array<long, 2> room{};
+  std::size_t available = DiscretionaryMessagesAvailable();
+  std::size_t deferred = 0;
+  for (bool inserts : {false, true}) {
+    if (inserts) {
+      room = PositionRoom();
+    }
+    for (std::size_t i = 0; i < bidActionCount + askActionCount; ++i) {
+      const bool isBid = i < bidActionCount;
+      const auto& action =
+          isBid ? bidActions[i] : askActions[i - bidActionCount];
+      if ((action.mType == QuoteActionType::INSERT) != inserts) {
+        continue;
+      }
+      if (available == 0) {
+        ++deferred;
+        continue;
+      }
+      switch (action.mType) {
+        case QuoteActionType::CANCEL:
+          SendCancelOrder(action.mClientOrderId);
+          --available;
+          break;
+        case QuoteActionType::AMEND:
+          // The exchange takes the order's new total volume
+          SendAmendOrder(action.mClientOrderId,
+                         mOrderBook[action.mClientOrderId].filledVolume +
+                             action.mVolume);
+          --available;
+          break;
+        case QuoteActionType::INSERT: {
+          const Side side = isBid ? Side::BUY : Side::SELL;
+          auto& left = room[static_cast<int>(side)];
+          const ulong volume =
+              std::min(action.mVolume, ulong(std::max(0L, left)));
+          if (volume != 0) {
+            SendInsertOrder(side, action.mPrice, volume,
+                            Lifespan::GOOD_FOR_DAY);
+            left -= long(volume);
+            --available;
+          }
+          break;
+        }
+      }
+    }
+  }
+  mQuotesDirty |= deferred != 0;
+
+  const auto& stats = mQuoteDiffer.GetStats();
+  RLOG(LG_AT, LogLevel::LL_INFO)
+      << "[UpdateQuotes] "
+      << "(bid " << bids[0].mPrice << "x" << bids[0].mVolume << ") "
+      << "(ask " << asks[0].mPrice << "x" << asks[0].mVolume << ") "
+      << "(messages " << bidActionCount + askActionCount << ", "
+      << deferred << " deferred) "
+      << "(total sent " << stats.mMessagesSent << " avoided "
+      << stats.mMessagesAvoided << ")";
 }
 
 void AutoTrader::OrderFilledMessageHandler(unsigned long clientOrderId,
@@ -304,6 +999,9 @@ void AutoTrader::OrderFilledMessageHandler(unsigned long clientOrderId,
                                  << "(price " << price << ") "
                                  << "(volume " << volume << ") ";
 
+  // The exchange follows every fill with the order's status
+  mLastFilledOrderId = clientOrderId;
+
   // If order was filled, hedge it and update internal tracker
   auto it = mOrderBook.find(clientOrderId);
   if (it == mOrderBook.end()) {
@@ -316,20 +1014,34 @@ void AutoTrader::OrderFilledMessageHandler(unsigned long clientOrderId,
   RLOG(LG_AT, LogLevel::LL_INFO) << "[OrderFilledMessageHandler] More Info: "
                                  << OrderInformation::ToString(order);
 
-  // Update order information
-  order.volume -= volume;
-  if (order.volume == 0) {
-    RLOG(LG_AT, LogLevel::LL_INFO)
-        << "[OrderFilledMessageHandler] "
-        << "(Order fully filled, clearing from internal order book)";
-    mOrderBook.erase(it);
+  if (order.state == OrderState::PENDING_CANCEL) {
+    RLOG(LG_AT, LogLevel::LL_WARNING) << "[OrderFilledMessageHandler] "
+                                      << "(filled while cancel pending)";
+  }
+
+  // Update order information. An amend on its way may already have taken
+  // the volume down; the order status that follows has the exchange's view
+  SetOrderVolume(order, order.volume - std::min(order.volume, volume));
+  order.filledVolume += volume;
+  if (order.instrument == Instrument::ETF) {
+    const long delta = order.side == Side::BUY ? long(volume) : -long(volume);
+    mETFPosition += delta;
+    mLotSizer.OnFill(order.side, volume);
+    ApplyPositionDelta(delta);
   }
+  ApplyOrderEvent(order, OrderEvent::FILLED);
+  const auto instrument = order.instrument;
+  const auto side = order.side;
+  const auto orderPrice = order.price;
+
+  if (instrument != Instrument::FUTURE) {
+    mQuotesDirty = true;
 
-  if (order.instrument != Instrument::FUTURE) {
-    // Hedge the order in the opposite side
+    // Hedge the order in the opposite side, netted against hedges that are
+    // in flight or waiting to be retried
     // TODO hedge with a better price
     //      right now you get (fill price - og price) * volume
-    SendHedgeOrder(!order.side, order.price, volume);
+    HedgeOutstanding(!side, orderPrice);
   }
 }
 
@@ -343,6 +1055,92 @@ void AutoTrader::OrderStatusMessageHandler(unsigned long clientOrderId,
       << "(fillVolume " << fillVolume << ")"
       << "(remainingVolume " << remainingVolume << ")"
       << "(fees " << fees << ")";
+
+  const bool afterFill = clientOrderId == mLastFilledOrderId;
+  mLastFilledOrderId = 0;
+
+  auto it = mOrderBook.find(clientOrderId);
+  if (it == mOrderBook.end()) {
+    return;
+  }
+  auto& order = it->second;
+
+  // A status right after a fill reports the fill, any other answers a
+  // request
+  const OrderEvent event =
+      remainingVolume == 0
+          ? (afterFill ? OrderEvent::FULLY_FILLED : OrderEvent::CLOSED)
+          : (afterFill ? OrderEvent::FILLED : OrderEvent::ACKNOWLEDGED);
+  const auto state = ApplyOrderEvent(order, event);
+
+  if (state == OrderState::DONE) {
+    // Finished with: cancelled, filled, or a fill-and-kill order that has
+    // done all it will
+    mQuotesDirty |= order.lifespan == Lifespan::GOOD_FOR_DAY;
+    EraseOrder(it);
+    return;
+  }
+  if (order.unknown) {
+    // Reconcile orders whose state was lost with the execution connection
+    mQuotesDirty = true;
+    order.unknown = false;
+  }
+  if (state != OrderState::PENDING_AMEND) {
+    SetOrderVolume(order, remainingVolume);
+  }
+}
+
+AutoTrader::OrderBook::iterator AutoTrader::EraseOrder(
+    OrderBook::iterator it) {
+  const auto& order = it->second;
+  if (order.instrument == Instrument::FUTURE) {
+    // Whatever the hedge had left will not be filled now
+    (order.side == Side::BUY ? mHedgeBuyInFlight : mHedgeSellInFlight) -=
+        long(order.volume);
+  } else {
+    --mETFOrderCount;
+    mETFOrderVolume -= order.volume;
+    mETFSideVolume[static_cast<int>(order.side)] -= order.volume;
+  }
+  return mOrderBook.erase(it);
+}
+
+void AutoTrader::TrackETFOrder(const OrderInformation& order) {
+  ++mETFOrderCount;
+  mETFOrderVolume += order.volume;
+  mETFSideVolume[static_cast<int>(order.side)] += order.volume;
+}
+
+void AutoTrader::SetOrderVolume(OrderInformation& order, unsigned long volume) {
+  if (order.instrument == Instrument::ETF) {
+    mETFOrderVolume = mETFOrderVolume - order.volume + volume;
+    auto& sideVolume = mETFSideVolume[static_cast<int>(order.side)];
+    sideVolume = sideVolume - order.volume + volume;
+  }
+  order.volume = volume;
+}
+
+OrderState AutoTrader::ApplyOrderEvent(OrderInformation& order,
+                                       OrderEvent event) {
+  const auto transition = OrderLifecycle::Apply(order.state, event);
+  if (transition.mAcknowledges || isPending(transition.mNext)) {
+    const auto now = LatencyHistogram::Clock::now();
+    if (transition.mAcknowledges) {
+      auto& latency = mAckLatency[static_cast<std::size_t>(order.state)];
+      latency.Record(order.sentAt, now);
+      RLOG(LG_AT, LogLevel::LL_INFO)
+          << "[ApplyOrderEvent] "
+          << "(clientOrderId " << order.id << ") "
+          << "(" << orderStateName(order.state) << " acknowledged, p50 "
+          << latency.Percentile(0.5) << "ns max " << latency.Max()
+          << "ns over " << latency.Count() << ")";
+    }
+    if (isPending(transition.mNext) && transition.mNext != order.state) {
+      order.sentAt = now;
+    }
+  }
+  order.state = transition.mNext;
+  return order.state;
 }
 
 void AutoTrader::TradeTicksMessageHandler(
@@ -363,4 +1161,21 @@ void AutoTrader::TradeTicksMessageHandler(
       << " (ticks " << mTicks << ") "
       << " (seq " << sequenceNumber << ") "
       << Utilities::InstrumentToString(instrument) << " " << ss.str();
+
+  if (instrument == Instrument::ETF) {
+    for (auto& [id, order] : mOrderBook) {
+      if (order.instrument == Instrument::ETF) {
+        order.queue.OnTradeTicks(askPrices, askVolumes, bidPrices, bidVolumes);
+      }
+    }
+    mInventoryQuoter.OnTradeTicks(mFairValue.GetRawTheoreticalPrice(),
+                                  askPrices, askVolumes, bidPrices,
+                                  bidVolumes);
+  }
+
+  if (mFairValue.OnTradeTicks(instrument, askPrices, askVolumes, bidPrices,
+                              bidVolumes) &&
+      IsExecutionConnected()) {
+    UpdateQuotes();
+  }
 }
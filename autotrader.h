@@ -18,14 +18,30 @@
 #ifndef CPPREADY_TRADER_GO_AUTOTRADER_H
 #define CPPREADY_TRADER_GO_AUTOTRADER_H
 
+#include <ready_trader_go/agelist.h>
 #include <ready_trader_go/baseautotrader.h>
+#include <ready_trader_go/bookstate.h>
+#include <ready_trader_go/doublebuffer.h>
+#include <ready_trader_go/fairvalue.h>
+#include <ready_trader_go/inventoryquoter.h>
+#include <ready_trader_go/latencyhistogram.h>
+#include <ready_trader_go/lotsizer.h>
+#include <ready_trader_go/messagebudget.h>
+#include <ready_trader_go/orderstate.h>
+#include <ready_trader_go/ownprices.h>
+#include <ready_trader_go/queueposition.h>
+#include <ready_trader_go/quotediff.h>
+#include <ready_trader_go/timerwheel.h>
 #include <ready_trader_go/types.h>
+#include <ready_trader_go/unhedgedlots.h>
 
+#include <algorithm>
 #include <array>
 #include <boost/asio/io_context.hpp>
 #include <boost/circular_buffer.hpp>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 #include "ready_trader_go/logging.h"
@@ -91,6 +107,19 @@ struct OrderInformation {
   unsigned long volume;
   ReadyTraderGo::Lifespan lifespan;
   ReadyTraderGo::Instrument instrument;
+  // Set after a reconnection until the exchange reports the order's status
+  bool unknown = false;
+  // Lifecycle state, and when the request it is pending on was sent
+  ReadyTraderGo::OrderState state = ReadyTraderGo::OrderState::PENDING_NEW;
+  ReadyTraderGo::LatencyHistogram::Clock::time_point sentAt;
+  // Volume traded so far
+  unsigned long filledVolume = 0;
+  // Estimated volume ahead of a resting ETF order at its price
+  ReadyTraderGo::QueuePosition queue;
+  // Place among the resting ETF orders, oldest first, and at our own
+  // resting prices
+  ReadyTraderGo::AgeListHook<OrderInformation> age;
+  ReadyTraderGo::OwnPriceLevels::Entry ownPrice;
 
   inline static std::string ToString(const OrderInformation &order) {
     std::stringstream ss;
@@ -101,24 +130,124 @@ struct OrderInformation {
        << "(price " << order.price << ") "
        << "(volume " << order.volume << ") "
        << "(volume " << Utilities::LifespanToString(order.lifespan) << ")"
+       << "(state " << ReadyTraderGo::orderStateName(order.state) << ")"
        << ")";
 
     return ss.str();
   }
 };
 
+// How the best bid and ask to quote are chosen: join the touch, or quote
+// around an inventory-skewed reservation price (see InventoryQuoter)
+enum class PricingPolicy { TOUCH, INVENTORY };
+
+// Tunable parameters, read from the "Parameters" section of the
+// configuration and reloaded when the autotrader receives SIGHUP.
+struct StrategyParameters {
+  unsigned long lotSize = 10;
+  long positionLimit = 100;
+  unsigned long tickSizeInCents = 100;
+  // ETF prices are valued within this fraction of the future price
+  double etfClamp = 0.002;
+  // Number of price levels quoted on each side, the gap between them in
+  // ticks, and the extra volume at each level further from the best price
+  unsigned long ladderLevels = 1;
+  unsigned long ladderSpacing = 1;
+  unsigned long ladderVolumeIncrement = 0;
+  // Most lots taken by one fill-and-kill order against stale ETF prices
+  // (zero to never take), and the edge over fair value required: the base
+  // edge when flat, plus up to the skew more when adding to a position at
+  // the limit (less when reducing one)
+  unsigned long takerVolume = 10;
+  long takerEdgeTicks = 2;
+  long takerSkewTicks = 2;
+  // Seconds before the exchange's unhedged lots deadline at which to start
+  // hedging more aggressively
+  double unhedgedMarginSeconds = 10.0;
+  // Resting orders older than this many ticks are cancelled, and quotes are
+  // not placed more than this many ticks behind the best price (zero for no
+  // limit)
+  unsigned long maxOrderAgeTicks = 0;
+  unsigned long maxQuoteDistanceTicks = 0;
+  // Size the nearest ladder level from the position, the depth at the best
+  // price and recent fills (see LotSizer) rather than always quoting lotSize
+  bool adaptiveLotSize = true;
+  unsigned long minLotSize = 1;
+  unsigned long maxLotSize = 50;
+  double depthFraction = 0.5;
+  double fillRateHalfLifeTicks = 20.0;
+  double targetFillRate = 1.0;
+  // Pricing policy, and the inventory model's risk aversion (per cent, see
+  // InventoryQuoterConfig), horizon in ticks and estimator half-lives
+  PricingPolicy pricingPolicy = PricingPolicy::TOUCH;
+  double riskAversion = 0.0001;
+  double horizonTicks = 5.0;
+  double volatilityHalfLifeTicks = 50.0;
+  double intensityHalfLife = 50.0;
+
+  // Derived from the above by Derive()
+  unsigned long minBidNearestTick = 0;
+  unsigned long maxAskNearestTick = 0;
+  std::array<unsigned long, ReadyTraderGo::MAX_QUOTE_LEVELS> ladderVolumes{};
+  unsigned long ladderTotalVolume = 0;
+
+  // Edge in cents needed to buy or sell, by ETF position bucket (see
+  // TakerBucket)
+  static constexpr std::size_t TAKER_BUCKETS = 21;
+  std::array<long, TAKER_BUCKETS> takerBuyEdge{};
+  std::array<long, TAKER_BUCKETS> takerSellEdge{};
+
+  std::size_t TakerBucket(long position) const {
+    const long last = TAKER_BUCKETS - 1;
+    const long bucket =
+        (position + positionLimit) * last / (2 * positionLimit);
+    return std::size_t(std::clamp(bucket, 0L, last));
+  }
+
+  void Derive() {
+    minBidNearestTick = (ReadyTraderGo::MINIMUM_BID + tickSizeInCents) /
+                        tickSizeInCents * tickSizeInCents;
+    maxAskNearestTick =
+        ReadyTraderGo::MAXIMUM_ASK / tickSizeInCents * tickSizeInCents;
+    ladderTotalVolume = 0;
+    for (std::size_t i = 0; i < ladderVolumes.size(); ++i) {
+      ladderVolumes[i] =
+          i < ladderLevels ? lotSize + i * ladderVolumeIncrement : 0;
+      ladderTotalVolume += ladderVolumes[i];
+    }
+    const long middle = TAKER_BUCKETS / 2;
+    for (std::size_t i = 0; i < TAKER_BUCKETS; ++i) {
+      const long skew = takerSkewTicks * (long(i) - middle) / middle;
+      takerBuyEdge[i] = std::max(0L, takerEdgeTicks + skew) *
+                        long(tickSizeInCents);
+      takerSellEdge[i] = std::max(0L, takerEdgeTicks - skew) *
+                         long(tickSizeInCents);
+    }
+  }
+};
+
 class AutoTrader : public ReadyTraderGo::BaseAutoTrader {
  public:
   explicit AutoTrader(boost::asio::io_context &context);
 
+  // Called when the configuration is loaded or reloaded. Missing parameters
+  // keep their current values; the new set takes effect before the next
+  // message is handled.
+  void LoadParameters(const boost::property_tree::ptree &tree) override;
+
   // Called when the execution connection is lost.
   void DisconnectHandler() override;
 
+  // Called when the execution connection has been re-established. Every
+  // recorded order is marked unknown until an order status message confirms
+  // it; orders still unknown after RESYNC_TICKS are forgotten.
+  void ReconnectedHandler() override;
+
   // Called when the matching engine detects an error.
   // If the error pertains to a particular order, then the client_order_id
   // will identify that order, otherwise the client_order_id will be zero.
   void ErrorMessageHandler(unsigned long clientOrderId,
-                           const std::string &errorMessage) override;
+                           std::string_view errorMessage) override;
 
   // Called when one of your hedge orders is filled, partially or fully.
   //
@@ -226,17 +355,200 @@ class AutoTrader : public ReadyTraderGo::BaseAutoTrader {
 
   inline void SendCancelOrder(unsigned long clientOrderId) override;
 
+  const ReadyTraderGo::LatencyHistogram &GetTakerLatency() const {
+    return mTakerLatency;
+  }
+
+  // Time from sending a request to the exchange's first word on it, for
+  // the pending state the request puts an order in
+  const ReadyTraderGo::LatencyHistogram &GetAckLatency(
+      ReadyTraderGo::OrderState pending) const {
+    return mAckLatency[static_cast<std::size_t>(pending)];
+  }
+
+  // Times the unhedged lots deadline has drawn near enough to hedge more
+  // aggressively
+  unsigned long GetHedgeEscalations() const { return mHedgeEscalations; }
+
+  // Inserts not sent because they would have traded with our own orders
+  unsigned long GetSelfTradesPrevented() const {
+    return mSelfTradesPrevented;
+  }
+
+  const ReadyTraderGo::QuoteDiffStats &GetQuoteDiffStats() const {
+    return mQuoteDiffer.GetStats();
+  }
+
+  // Queue position estimate of a resting ETF order, or nullptr if there is
+  // no such order
+  const ReadyTraderGo::QueuePosition *GetQueuePosition(
+      unsigned long clientOrderId) const;
+
  private:
+  using OrderBook = std::unordered_map<ulong, OrderInformation>;
+
+  // Send a fill-and-kill order against ETF prices on the other side that are
+  // beyond the fair value by the required edge. Called first thing on every
+  // order book update; at most one order per side per ETF snapshot. The time
+  // from 'received' to the order being sent is recorded.
+  void TakeStalePrices(ReadyTraderGo::Side side,
+                       ReadyTraderGo::LatencyHistogram::Clock::time_point
+                           received);
+
+  // Apply a change in the ETF or future position to the unhedged lots,
+  // (re)arming or cancelling the unhedged lots timer as the deadline
+  // appears, moves or goes.
+  void ApplyPositionDelta(long delta);
+
+  // Called the safety margin before the unhedged lots deadline, then every
+  // HEDGE_ESCALATION_INTERVAL until the position is back within the limit.
+  // Each call hedges everything not already being hedged, crossing the
+  // future's book by one more tick than the last.
+  void UnhedgedTimerHandler();
+
+  // Price for a hedge order on the given side that crosses the future's
+  // best opposite price by the given number of ticks, or any valid price
+  // once that reaches HEDGE_ESCALATION_LEVELS. Zero if there is no price to
+  // cross.
+  unsigned long HedgePrice(ReadyTraderGo::Side side,
+                           unsigned long escalation) const;
+
+  // Future lots to buy (negative to sell) to hedge the ETF position, less
+  // what the hedges in flight will do if they are filled
+  long UnhedgedFutureLots() const {
+    return -(mETFPosition + mFUTPosition + mHedgeBuyInFlight -
+             mHedgeSellInFlight);
+  }
+
+  // Send one hedge order for UnhedgedFutureLots, at 'price' if it is on
+  // 'side' and at HedgePrice for the current escalation otherwise. The
+  // volume is cut so that the future position stays within the limit even
+  // if every hedge in flight is filled.
+  void HedgeOutstanding(ReadyTraderGo::Side side = ReadyTraderGo::Side::BUY,
+                        unsigned long price = 0);
+
+  // Count a message sent to the exchange, and the messages that may still be
+  // sent now without eating into what is kept back for hedges
+  void CountMessage() { mMessageBudget.Record(mTimers.Now()); }
+  std::size_t DiscretionaryMessagesAvailable();
+
+  // Move an order through its lifecycle, recording the acknowledgement
+  // latency if the event answers a pending request. Returns the new state;
+  // the caller erases orders that are DONE.
+  ReadyTraderGo::OrderState ApplyOrderEvent(OrderInformation &order,
+                                            ReadyTraderGo::OrderEvent event);
+
+  // Remove an order from mOrderBook, taking whatever volume a hedge had
+  // left out of the hedges in flight, and an ETF order out of the ETF
+  // totals. Returns the next order.
+  OrderBook::iterator EraseOrder(OrderBook::iterator it);
+
+  // Keep the ETF totals in step with mOrderBook: count a newly recorded ETF
+  // order, and change an order's remaining volume.
+  void TrackETFOrder(const OrderInformation &order);
+  void SetOrderVolume(OrderInformation &order, unsigned long volume);
+
+  // Cancel resting orders that have reached the maximum age, oldest first,
+  // so that their levels are quoted afresh. Costs nothing for orders that
+  // are younger.
+  void SweepStaleOrders();
+
+  // Replace the ladder's volumes for one side with ones sized by
+  // mLotSizer, keeping the whole ladder within the side's share of the
+  // active volume limit.
+  void SizeLadder(
+      ReadyTraderGo::Side side, unsigned long touchVolume,
+      std::array<unsigned long, ReadyTraderGo::MAX_QUOTE_LEVELS> &volumes)
+      const;
+
+  // Cut a side's ladder, nearest level first, so that it could all be
+  // filled, along with the side's volume outside the ladder, without the
+  // ETF position passing the limit.
+  void CapLadder(
+      ReadyTraderGo::Side side, unsigned long unquotedVolume,
+      std::array<unsigned long, ReadyTraderGo::MAX_QUOTE_LEVELS> &volumes)
+      const;
+
+  // Lots that may still be bought (index BUY) or sold (index SELL) without
+  // the ETF position passing the limit, if every ETF order we have were
+  // filled
+  std::array<long, 2> PositionRoom() const;
+
+  // Bring the ETF quote ladders up to date with the book and fair value,
+  // sending only the messages needed to turn the live orders into the target
+  // quotes. Does nothing if neither the targets nor the live orders have
+  // changed. Within the message budget, inserts are the first to be put off,
+  // until the next update. Uses no heap memory.
+  void UpdateQuotes();
+
   // Ticks since start
   ulong mTicks = 0;
 
+  ReadyTraderGo::DoubleBuffer<StrategyParameters> mParameters;
+
+  // Tick at which the last reconnection happened, and whether any recorded
+  // orders are still awaiting confirmation since then
+  ulong mResyncTick = 0;
+  bool mResyncing = false;
+
   // client order, just tracking one order
   ulong mOrderId = 1;
-  std::unordered_map<ulong, OrderInformation> mOrderBook;
+  // Prices of the resting ETF orders in mOrderBook, which must outlive it
+  ReadyTraderGo::OwnPriceLevels mOwnPrices;
+  unsigned long mSelfTradesPrevented = 0;
+  // ETF orders in mOrderBook and their remaining volume, in total and by
+  // side, so that the taker path need not walk the orders
+  ulong mETFOrderCount = 0;
+  ulong mETFOrderVolume = 0;
+  std::array<ulong, 2> mETFSideVolume{};
+  OrderBook mOrderBook;
+  // Resting ETF orders in mOrderBook, in the order they were sent
+  ReadyTraderGo::AgeList<OrderInformation> mOrderAges;
+
+  // The order of the last fill message, whose order status message is
+  // expected next, and acknowledgement latency by pending state
+  ulong mLastFilledOrderId = 0;
+  std::array<ReadyTraderGo::LatencyHistogram, ReadyTraderGo::ORDER_STATE_COUNT>
+      mAckLatency;
+
+  // Latest order book snapshot of each instrument, indexed by Instrument
+  std::array<ReadyTraderGo::BookState, 2> mBooks;
+
+  // ETF fair value and clamp bounds, derived from both books
+  ReadyTraderGo::FairValue mFairValue;
+
+  // Quote sizes, when adaptive, and quote prices under the inventory policy
+  ReadyTraderGo::LotSizer mLotSizer;
+  ReadyTraderGo::InventoryQuoter mInventoryQuoter;
+
+  // Messages sent to the exchange in its frequency interval
+  ReadyTraderGo::MessageBudget mMessageBudget;
+
+  // Quotes last asked for, and whether our ETF orders have changed since
+  ReadyTraderGo::QuoteDiffer mQuoteDiffer;
+  ReadyTraderGo::QuoteLevels mQuotedBids{};
+  ReadyTraderGo::QuoteLevels mQuotedAsks{};
+  bool mQuotesDirty = true;
+
+  // ETF snapshot last taken against, by side, and the time from receiving an
+  // order book to sending a fill-and-kill order
+  std::array<unsigned long, 2> mTakenSequence{};
+  ReadyTraderGo::LatencyHistogram mTakerLatency;
 
   // Position trackers
   long mETFPosition = 0;
   long mFUTPosition = 0;
+
+  // The exchange's view of our unhedged lots, and the timer for its deadline
+  ReadyTraderGo::UnhedgedLots mUnhedgedLots;
+  ReadyTraderGo::WheelTimer mUnhedgedTimer;
+  unsigned long mHedgeEscalation = 0;
+  unsigned long mHedgeEscalations = 0;
+
+  // Future lots in hedge orders awaiting a reply, by side. Lots whose hedge
+  // failed are left in UnhedgedFutureLots and hedged again.
+  long mHedgeBuyInFlight = 0;
+  long mHedgeSellInFlight = 0;
 };
 
 #endif  // CPPREADY_TRADER_GO_AUTOTRADER_H
@@ -0,0 +1,265 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/asio/io_context.hpp>
+#include <boost/log/core.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <ready_trader_go/error.h>
+#include <simulator/backtest.h>
+#include <simulator/marketdata.h>
+
+#include "autotrader.h"
+
+using namespace ReadyTraderGo;
+
+// Runs the autotrader against each market data file through the simulated
+// exchange at several latencies and reports its profit or loss, so the
+// value of a faster trader can be read off in dollars.
+//
+// Usage: bench_backtest [--config JSON FILE] [--latency FEED MS[,ORDER MS]]...
+//                       [--hedge-outage START S,END S] [--scores DIRECTORY]
+//                       [MARKET DATA FILE...]
+// Each --latency sets the one-way delay from the exchange to the trader and,
+// if given separately, from the trader to the exchange (by default the
+// same). With no latencies a range from 0 to 100ms is tried, and with no
+// data files every data/market_data*.csv file is replayed. With
+// --hedge-outage, every hedge between the two times (in seconds from the
+// start) fails, which exercises the trader's unhedged lots escalation. With
+// --scores, each run's score board is written to the directory for
+// score_summary.
+
+#ifndef RTG_DATA_DIR
+#define RTG_DATA_DIR "data"
+#endif
+
+static std::vector<std::string> defaultDataFiles()
+{
+    std::vector<std::string> files;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(RTG_DATA_DIR, error))
+    {
+        const auto name = entry.path().filename().string();
+        if (name.rfind("market_data", 0) == 0 && entry.path().extension() == ".csv")
+            files.push_back(entry.path().string());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+static bool parseLatency(const std::string& text, std::pair<double, double>& latency)
+{
+    try
+    {
+        std::size_t end = 0;
+        latency.first = std::stod(text, &end) / 1000.0;
+        latency.second = latency.first;
+        if (end < text.size() && text[end] == ',')
+        {
+            const std::string order = text.substr(end + 1);
+            latency.second = std::stod(order, &end) / 1000.0;
+            end += text.size() - order.size();
+        }
+        return end == text.size() && latency.first >= 0.0 && latency.second >= 0.0;
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+}
+
+static bool parseOutage(const std::string& text, BacktestConfig& config)
+{
+    try
+    {
+        std::size_t end = 0;
+        config.mHedgeOutageStart = std::stod(text, &end);
+        if (end >= text.size() || text[end] != ',')
+            return false;
+        const std::string finish = text.substr(end + 1);
+        config.mHedgeOutageEnd = std::stod(finish, &end);
+        return end == finish.size() && config.mHedgeOutageStart >= 0.0
+               && config.mHedgeOutageEnd > config.mHedgeOutageStart;
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+}
+
+static double dollars(long cents)
+{
+    return static_cast<double>(cents) / 100.0;
+}
+
+int main(int argc, char* argv[])
+{
+    boost::log::core::get()->set_logging_enabled(false);
+
+    boost::property_tree::ptree config;
+    std::vector<std::pair<double, double>> latencies;
+    std::vector<std::string> files;
+    std::filesystem::path scoresDirectory;
+    BacktestConfig backtestConfig;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--config" && i + 1 < argc)
+        {
+            try
+            {
+                boost::property_tree::read_json(argv[++i], config);
+            }
+            catch (const boost::property_tree::ptree_error& e)
+            {
+                std::cerr << e.what() << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--latency" && i + 1 < argc)
+        {
+            std::pair<double, double> latency;
+            if (!parseLatency(argv[++i], latency))
+            {
+                std::cerr << "invalid latency: " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+            latencies.push_back(latency);
+        }
+        else if (arg == "--hedge-outage" && i + 1 < argc)
+        {
+            if (!parseOutage(argv[++i], backtestConfig))
+            {
+                std::cerr << "invalid hedge outage: " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--scores" && i + 1 < argc)
+        {
+            scoresDirectory = argv[++i];
+        }
+        else
+        {
+            files.push_back(arg);
+        }
+    }
+    if (latencies.empty())
+        latencies = {{0.0, 0.0}, {0.001, 0.001}, {0.005, 0.005}, {0.02, 0.02}, {0.1, 0.1}};
+    if (files.empty())
+        files = defaultDataFiles();
+    if (files.empty())
+    {
+        std::cerr << "no market data files found in " << RTG_DATA_DIR << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::vector<MarketEvent>> data;
+    for (const auto& file : files)
+    {
+        try
+        {
+            data.push_back(readMarketData(file));
+        }
+        catch (const ReadyTraderGoError& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!scoresDirectory.empty())
+    {
+        std::error_code error;
+        std::filesystem::create_directories(scoresDirectory, error);
+        if (error)
+        {
+            std::cerr << "failed to create " << scoresDirectory << ": " << error.message() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& [feedLatency, orderLatency] : latencies)
+    {
+        backtestConfig.mFeedLatency = feedLatency;
+        backtestConfig.mOrderLatency = orderLatency;
+
+        std::cout << "latency feed=" << feedLatency * 1000.0 << "ms order=" << orderLatency * 1000.0 << "ms"
+                  << std::endl;
+        long total = 0;
+        for (std::size_t i = 0; i < files.size(); ++i)
+        {
+            boost::asio::io_context context;
+            AutoTrader trader{context};
+            try
+            {
+                trader.LoadParameters(config);
+            }
+            catch (const ReadyTraderGoError& e)
+            {
+                std::cerr << e.what() << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            Backtest backtest{data[i], trader, backtestConfig};
+            const BacktestResult result = backtest.Run();
+            total += result.mProfitOrLoss;
+
+            if (!scoresDirectory.empty())
+            {
+                const auto name = std::filesystem::path(files[i]).stem().string() + "-"
+                                  + std::to_string(std::lround(feedLatency * 1e6)) + "us-"
+                                  + std::to_string(std::lround(orderLatency * 1e6)) + "us.score";
+                try
+                {
+                    backtest.GetScoreBoard().Write((scoresDirectory / name).string());
+                }
+                catch (const ReadyTraderGoError& e)
+                {
+                    std::cerr << e.what() << std::endl;
+                    return EXIT_FAILURE;
+                }
+            }
+
+            std::cout << "  " << files[i] << ": pnl=" << dollars(result.mProfitOrLoss)
+                      << " drawdown=" << dollars(result.mMaxDrawdown)
+                      << " fees=" << dollars(result.mTotalFees)
+                      << " etf volume=" << result.mEtfVolume
+                      << " position=" << result.mEtfPosition << "/" << result.mFuturePosition
+                      << " messages=" << result.mMessagesSent
+                      << " errors=" << result.mErrors
+                      << " escalations=" << trader.GetHedgeEscalations();
+            if (result.mBreached)
+                std::cout << " BREACH (" << result.mBreachReason << ")";
+            std::cout << std::endl;
+        }
+        std::cout << "  total pnl=" << dollars(total) << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,55 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_BENCHMARKS_BENCHMARK_H
+#define CPPREADY_TRADER_GO_BENCHMARKS_BENCHMARK_H
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace ReadyTraderGo {
+
+// Prevent the compiler from optimising away a value computed by a benchmark.
+template<typename T>
+inline void doNotOptimise(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Run 'body' 'iterations' times and print the mean time per iteration.
+template<typename F>
+double runBenchmark(const std::string& name, std::size_t iterations, F&& body)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        body(i);
+    }
+    const auto finish = std::chrono::steady_clock::now();
+    const double nanoseconds = std::chrono::duration<double, std::nano>(finish - start).count();
+    const double perIteration = nanoseconds / static_cast<double>(iterations);
+    std::cout << std::left << std::setw(48) << name << std::right << std::setw(12) << std::fixed
+              << std::setprecision(2) << perIteration << " ns/op" << std::endl;
+    return perIteration;
+}
+
+}
+
+#endif //CPPREADY_TRADER_GO_BENCHMARKS_BENCHMARK_H
@@ -0,0 +1,128 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <ready_trader_go/bookstate.h>
+
+#include "benchmark.h"
+
+using namespace ReadyTraderGo;
+
+// Compares the book delta kernel selected at compile time with the scalar
+// implementation on a stream of order book snapshots, exiting with a failure
+// status if they ever disagree, and reports the cost of each.
+
+constexpr std::size_t SNAPSHOT_COUNT = 4096;
+constexpr std::size_t ITERATIONS = 5000000;
+
+struct Snapshot
+{
+    LevelArray mPrices;
+    LevelArray mVolumes;
+};
+
+static bool operator==(const BookSideDelta& a, const BookSideDelta& b)
+{
+    return a.mChangedLevels == b.mChangedLevels && a.mCumulativeVolumes == b.mCumulativeVolumes
+           && a.mNotional == b.mNotional;
+}
+
+// A random walk where each snapshot changes a few levels of the previous one.
+static std::vector<Snapshot> makeSnapshots()
+{
+    std::mt19937 random{20230302};
+    std::vector<Snapshot> result(SNAPSHOT_COUNT);
+    Snapshot current{};
+    for (std::size_t i = 0; i < TOP_LEVEL_COUNT; ++i)
+    {
+        current.mPrices[i] = 150000 - 100 * i;
+        current.mVolumes[i] = 100 + i;
+    }
+    for (auto& snapshot : result)
+    {
+        const auto changes = std::uniform_int_distribution<int>{0, 3}(random);
+        for (int c = 0; c < changes; ++c)
+        {
+            const auto level = std::uniform_int_distribution<std::size_t>{0, TOP_LEVEL_COUNT - 1}(random);
+            if (random() & 1)
+                current.mPrices[level] += 100;
+            else
+                current.mVolumes[level] = std::uniform_int_distribution<unsigned long>{0, 0xFFFFFFFFul}(random);
+        }
+        snapshot = current;
+    }
+    return result;
+}
+
+int main()
+{
+    const auto snapshots = makeSnapshots();
+    std::size_t mismatches = 0;
+
+    for (std::size_t i = 1; i < SNAPSHOT_COUNT; ++i)
+    {
+        const auto& previous = snapshots[i - 1];
+        const auto& current = snapshots[i];
+        BookSideDelta expected, actual;
+        ComputeBookSideDeltaScalar(current.mPrices, current.mVolumes, previous.mPrices, previous.mVolumes, expected);
+        ComputeBookSideDelta(current.mPrices, current.mVolumes, previous.mPrices, previous.mVolumes, actual);
+        if (!(expected == actual))
+        {
+            std::cerr << "snapshot " << i << ": " << BookDeltaKernelName() << " kernel disagrees with scalar"
+                      << std::endl;
+            ++mismatches;
+        }
+    }
+
+    std::cout << "kernel: " << BookDeltaKernelName() << std::endl;
+
+    BookSideDelta delta;
+    runBenchmark("scalar side delta", ITERATIONS, [&](std::size_t i) {
+        const auto& previous = snapshots[i % SNAPSHOT_COUNT];
+        const auto& current = snapshots[(i + 1) % SNAPSHOT_COUNT];
+        ComputeBookSideDeltaScalar(current.mPrices, current.mVolumes, previous.mPrices, previous.mVolumes, delta);
+        doNotOptimise(delta);
+    });
+    runBenchmark(std::string(BookDeltaKernelName()) + " side delta", ITERATIONS, [&](std::size_t i) {
+        const auto& previous = snapshots[i % SNAPSHOT_COUNT];
+        const auto& current = snapshots[(i + 1) % SNAPSHOT_COUNT];
+        ComputeBookSideDelta(current.mPrices, current.mVolumes, previous.mPrices, previous.mVolumes, delta);
+        doNotOptimise(delta);
+    });
+
+    BookState state;
+    runBenchmark("BookState::Update", ITERATIONS, [&](std::size_t i) {
+        const auto& asks = snapshots[i % SNAPSHOT_COUNT];
+        const auto& bids = snapshots[(i + 7) % SNAPSHOT_COUNT];
+        state.Update(i + 1, asks.mPrices, asks.mVolumes, bids.mPrices, bids.mVolumes);
+        doNotOptimise(state.GetDelta());
+    });
+
+    if (mismatches != 0)
+    {
+        std::cerr << mismatches << " mismatches" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "kernel matches scalar" << std::endl;
+    return EXIT_SUCCESS;
+}
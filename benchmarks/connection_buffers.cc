@@ -0,0 +1,168 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/endian/conversion.hpp>
+
+#include <ready_trader_go/connectivity.h>
+#include <ready_trader_go/protocol.h>
+#include <ready_trader_go/ringbuffer.h>
+
+#include "benchmark.h"
+
+using namespace ReadyTraderGo;
+
+// Compares the Connection buffer handling built on RingBuffer with the
+// equivalent boost::asio::streambuf code it replaced. The send path encodes
+// bursts of insert messages and drains them in partial writes that leave a
+// partial message behind; the receive path replays bursts of order status
+// messages split at arbitrary points.
+
+constexpr std::size_t ITERATIONS = 200000;
+constexpr std::size_t BURST = 16;
+
+static std::size_t encode(unsigned char* data, const ISerialisable& message, unsigned char type)
+{
+    const std::size_t size = MESSAGE_HEADER_SIZE + message.Size();
+    *(uint16_t*)data = boost::endian::native_to_big((uint16_t)size);
+    data[MESSAGE_TYPE_OFFSET] = type;
+    message.Serialise(data + MESSAGE_HEADER_SIZE);
+    return size;
+}
+
+static std::size_t parse(unsigned char const* begin, std::size_t available)
+{
+    auto* upto = begin;
+    unsigned long total = 0;
+    while (available >= MESSAGE_HEADER_SIZE)
+    {
+        const std::size_t messageLength = boost::endian::big_to_native(*(uint16_t*)upto);
+        if (available < messageLength)
+            break;
+        auto status = makeMessage<OrderStatusMessage>(upto + MESSAGE_HEADER_SIZE,
+                                                      messageLength - MESSAGE_HEADER_SIZE);
+        total += status.mRemainingVolume;
+        upto += messageLength;
+        available -= messageLength;
+    }
+    doNotOptimise(total);
+    return upto - begin;
+}
+
+// Stand in for a socket write of up to 'limit' of the 'size' bytes at 'data';
+// returns how many were written.
+static std::size_t write(unsigned char const* data, std::size_t size, std::size_t limit)
+{
+    doNotOptimise(data);
+    doNotOptimise(size);
+    return std::min(size, limit);
+}
+
+// Copy the next 'chunk' bytes of the (cyclic) feed and return the new offset.
+static std::size_t replay(unsigned char* dest, const std::vector<unsigned char>& feed,
+                          std::size_t offset, std::size_t chunk)
+{
+    const std::size_t first = std::min(chunk, feed.size() - offset);
+    std::memcpy(dest, feed.data() + offset, first);
+    std::memcpy(dest + first, feed.data(), chunk - first);
+    return (offset + chunk) % feed.size();
+}
+
+int main()
+{
+    const InsertMessage insert{1, Side::BUY, 10000, 10, Lifespan::GOOD_FOR_DAY};
+    const std::size_t insertSize = MESSAGE_HEADER_SIZE + insert.Size();
+
+    std::vector<unsigned char> feed;
+    for (std::size_t i = 0; i < 4096; ++i)
+    {
+        unsigned char message[64];
+        auto n = encode(message, OrderStatusMessage{i, 1, 9, -1}, MessageType::ORDER_STATUS);
+        feed.insert(feed.end(), message, message + n);
+    }
+
+    std::cout << "send path (" << BURST << " messages per burst)" << std::endl;
+    {
+        boost::asio::streambuf out;
+        runBenchmark("  boost::asio::streambuf", ITERATIONS, [&](std::size_t i) {
+            for (std::size_t j = 0; j < BURST; ++j)
+            {
+                auto buf = out.prepare(insertSize);
+                encode(static_cast<unsigned char*>(buf.data()), insert, MessageType::INSERT_ORDER);
+                out.commit(insertSize);
+            }
+            // Drain in two partial writes, as a busy socket would, leaving
+            // a partial message behind for the next burst.
+            auto* data = static_cast<unsigned char const*>(out.data().data());
+            out.consume(write(data, out.size(), out.size() / 3 + (i & 7)));
+            data = static_cast<unsigned char const*>(out.data().data());
+            out.consume(write(data, out.size(), out.size() - (i & 15)));
+        });
+    }
+    {
+        RingBuffer out{CONNECTION_OUT_BUFFER_SIZE};
+        runBenchmark("  RingBuffer", ITERATIONS, [&](std::size_t i) {
+            for (std::size_t j = 0; j < BURST; ++j)
+            {
+                encode(out.Prepare(insertSize), insert, MessageType::INSERT_ORDER);
+                out.Commit(insertSize);
+            }
+            // As Connection::WriteSomeHandler does, compact the unsent bytes
+            // before the second write is issued.
+            out.Consume(write(out.Data(), out.Size(), out.Size() / 3 + (i & 7)));
+            out.Compact();
+            out.Consume(write(out.Data(), out.Size(), out.Size() - (i & 15)));
+        });
+        std::cout << "  high water mark=" << out.GetStats().mHighWaterMark
+                  << " wraps=" << out.GetStats().mWraps << std::endl;
+    }
+
+    std::cout << "receive path (reads split mid-message)" << std::endl;
+    {
+        boost::asio::streambuf in;
+        std::size_t offset = 0;
+        runBenchmark("  boost::asio::streambuf", ITERATIONS, [&](std::size_t i) {
+            const std::size_t chunk = 97 + (i % 13) * 31;
+            auto buf = in.prepare(MAXIMUM_MESSAGE_SIZE);
+            offset = replay(static_cast<unsigned char*>(buf.data()), feed, offset, chunk);
+            in.commit(chunk);
+            in.consume(parse(static_cast<unsigned char const*>(in.data().data()), in.size()));
+        });
+    }
+    {
+        RingBuffer in{CONNECTION_IN_BUFFER_SIZE};
+        std::size_t offset = 0;
+        runBenchmark("  RingBuffer", ITERATIONS, [&](std::size_t i) {
+            const std::size_t chunk = 97 + (i % 13) * 31;
+            offset = replay(in.Prepare(MAXIMUM_MESSAGE_SIZE), feed, offset, chunk);
+            in.Commit(chunk);
+            in.Consume(parse(in.Data(), in.Size()));
+        });
+        std::cout << "  high water mark=" << in.GetStats().mHighWaterMark
+                  << " wraps=" << in.GetStats().mWraps << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/endian/conversion.hpp>
+#include <boost/log/core.hpp>
+
+#include <ready_trader_go/connectivity.h>
+#include <ready_trader_go/protocol.h>
+
+using namespace ReadyTraderGo;
+using boost::asio::ip::tcp;
+
+// Counts heap allocations made while the execution connection and the
+// information subscription are in steady state. Exits with a failure status
+// if any allocation is observed after warm-up.
+
+static std::atomic<bool> gCounting{false};
+static std::atomic<std::size_t> gAllocations{0};
+
+void* operator new(std::size_t size)
+{
+    if (gCounting.load(std::memory_order_relaxed))
+        gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+constexpr std::size_t WARM_UP = 1000;
+constexpr std::size_t ITERATIONS = 20000;
+constexpr char INFO_FILENAME[] = "bench_handler_allocation.dat";
+
+static std::size_t measure(std::size_t iterations, const std::function<void()>& step)
+{
+    for (std::size_t i = 0; i < WARM_UP; ++i)
+        step();
+    gAllocations = 0;
+    gCounting = true;
+    for (std::size_t i = 0; i < iterations; ++i)
+        step();
+    gCounting = false;
+    return gAllocations;
+}
+
+int main()
+{
+    // Only the I/O path is of interest here, not the log records it writes.
+    boost::log::core::get()->set_logging_enabled(false);
+
+    boost::asio::io_context context;
+
+    // Execution connection: a round trip of one insert out and one order
+    // status back per iteration.
+    tcp::acceptor acceptor{context, tcp::endpoint{boost::asio::ip::address_v4::loopback(), 0}};
+    tcp::socket client{context};
+    client.connect(acceptor.local_endpoint());
+    tcp::socket peer = acceptor.accept();
+    client.non_blocking(true);
+
+    Connection connection{context, std::move(client)};
+    std::size_t received = 0;
+    connection.MessageReceived = [&received](IConnection*, unsigned char, unsigned char const*, std::size_t) {
+        ++received;
+    };
+    connection.AsyncRead();
+
+    const InsertMessage insert{1, Side::BUY, 10000, 10, Lifespan::GOOD_FOR_DAY};
+    const OrderStatusMessage status{1, 0, 10, 0};
+    unsigned char reply[MESSAGE_HEADER_SIZE + 16];
+    *(uint16_t*)reply = boost::endian::native_to_big((uint16_t)sizeof(reply));
+    reply[MESSAGE_TYPE_OFFSET] = MessageType::ORDER_STATUS;
+    status.Serialise(reply + MESSAGE_HEADER_SIZE);
+    unsigned char sink[4096];
+
+    auto roundTrip = [&]() {
+        const std::size_t expected = received + 1;
+        connection.SendMessage(MessageType::INSERT_ORDER, insert, SendMode::SOON);
+        boost::asio::write(peer, boost::asio::buffer(reply));
+        while (received < expected)
+            context.poll();
+        while (peer.available() > 0)
+            peer.read_some(boost::asio::buffer(sink));
+    };
+    const std::size_t connectionAllocations = measure(ITERATIONS, roundTrip);
+
+    // Information subscription: the polling loop over an idle transport.
+    {
+        std::ofstream file{INFO_FILENAME, std::ios::binary};
+        std::vector<char> zeros(SUBSCRIPTION_TRANSPORT_BUFFER_SIZE, 0);
+        file.write(zeros.data(), zeros.size());
+    }
+    SubscriptionFactory factory{context, "mmap", INFO_FILENAME};
+    auto subscription = factory.Create();
+    subscription->AsyncReceive();
+    const std::size_t subscriptionAllocations = measure(ITERATIONS, [&]() { context.run_one(); });
+    subscription.reset();
+    std::remove(INFO_FILENAME);
+
+    std::cout << "execution round trips: " << ITERATIONS << ", allocations: " << connectionAllocations << std::endl;
+    std::cout << "subscription polls:    " << ITERATIONS << ", allocations: " << subscriptionAllocations << std::endl;
+
+    return (connectionAllocations == 0 && subscriptionAllocations == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
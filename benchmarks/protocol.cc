@@ -0,0 +1,255 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <ready_trader_go/error.h>
+#include <ready_trader_go/protocol.h>
+
+#include "benchmark.h"
+
+using namespace ReadyTraderGo;
+
+// Property checks and throughput measurements for every message type in
+// protocol.h. For each type:
+//   1. a known message must serialise to a known sequence of bytes;
+//   2. random messages must survive a serialise/deserialise round trip;
+//   3. deserialising random bytes must be stable under re-serialisation,
+//      truncated input must be rejected and trailing bytes ignored; and
+//   4. serialise and deserialise throughput is reported.
+// The process exits with a failure status if any property does not hold.
+
+constexpr std::size_t ROUND_TRIPS = 10000;
+constexpr std::size_t FUZZ_CASES = 10000;
+constexpr std::size_t THROUGHPUT_ITERATIONS = 2000000;
+
+using Bytes = std::vector<unsigned char>;
+using Prices = std::array<unsigned long, TOP_LEVEL_COUNT>;
+
+static std::mt19937 gRandom{20230301};
+static std::size_t gFailures = 0;
+
+static unsigned long randomLong()
+{
+    return std::uniform_int_distribution<unsigned long>{0, 0xFFFFFFFFul}(gRandom);
+}
+
+static unsigned char randomByte()
+{
+    return static_cast<unsigned char>(std::uniform_int_distribution<int>{0, 255}(gRandom));
+}
+
+static Prices randomPrices()
+{
+    Prices result;
+    for (auto& p : result)
+        p = randomLong();
+    return result;
+}
+
+static std::string randomString()
+{
+    std::string result(std::uniform_int_distribution<std::size_t>{0, MessageFieldSize::STRING}(gRandom), ' ');
+    for (auto& c : result)
+        c = static_cast<char>(std::uniform_int_distribution<int>{1, 127}(gRandom));
+    return result;
+}
+
+static Side randomSide() { return Side(randomByte() & 1); }
+static Lifespan randomLifespan() { return Lifespan(randomByte() & 1); }
+static Instrument randomInstrument() { return Instrument(randomByte() & 1); }
+
+template<typename M> M randomMessage();
+
+template<> AmendMessage randomMessage() { return {randomLong(), randomLong()}; }
+template<> CancelMessage randomMessage() { return CancelMessage{randomLong()}; }
+template<> ErrorMessage randomMessage() { return {randomLong(), randomString()}; }
+template<> HedgeMessage randomMessage() { return {randomLong(), randomSide(), randomLong(), randomLong()}; }
+template<> HedgeFilledMessage randomMessage() { return {randomLong(), randomLong(), randomLong()}; }
+template<> InsertMessage randomMessage()
+{
+    return {randomLong(), randomSide(), randomLong(), randomLong(), randomLifespan()};
+}
+template<> LoginMessage randomMessage() { return {randomString(), randomString()}; }
+template<> OrderBookMessage randomMessage()
+{
+    return {randomInstrument(), randomLong(), randomPrices(), randomPrices(), randomPrices(), randomPrices()};
+}
+template<> OrderFilledMessage randomMessage() { return {randomLong(), randomLong(), randomLong()}; }
+template<> OrderStatusMessage randomMessage()
+{
+    return {randomLong(), randomLong(), randomLong(), static_cast<signed long>(static_cast<int32_t>(randomLong()))};
+}
+template<> TradeTicksMessage randomMessage()
+{
+    return {randomInstrument(), randomLong(), randomPrices(), randomPrices(), randomPrices(), randomPrices()};
+}
+
+static Bytes serialise(const ISerialisable& message)
+{
+    Bytes result(message.Size());
+    message.Serialise(result.data());
+    return result;
+}
+
+static std::string toHex(const Bytes& bytes)
+{
+    std::string result;
+    char digits[3];
+    for (auto b : bytes)
+    {
+        std::snprintf(digits, sizeof(digits), "%02x", b);
+        result += digits;
+    }
+    return result;
+}
+
+static void fail(const char* name, const std::string& what)
+{
+    std::cout << "FAILED: " << name << ": " << what << std::endl;
+    ++gFailures;
+}
+
+template<typename M>
+static void checkMessage(const char* name, const M& known, const std::string& knownHex)
+{
+    // 1. Known encoding.
+    const auto encoded = toHex(serialise(known));
+    if (encoded != knownHex)
+        fail(name, "known message encoded as " + encoded + ", expected " + knownHex);
+
+    // 2. Round trip of random messages.
+    for (std::size_t i = 0; i < ROUND_TRIPS; ++i)
+    {
+        const auto bytes = serialise(randomMessage<M>());
+        const auto decoded = makeMessage<M>(bytes.data(), bytes.size());
+        if (serialise(decoded) != bytes)
+        {
+            fail(name, "round trip changed " + toHex(bytes));
+            break;
+        }
+    }
+
+    // 3. Random, truncated and oversized input.
+    const std::size_t size = M().Size();
+    for (std::size_t i = 0; i < FUZZ_CASES; ++i)
+    {
+        Bytes input(std::uniform_int_distribution<std::size_t>{0, size * 2}(gRandom));
+        for (auto& b : input)
+            b = randomByte();
+
+        M decoded;
+        try
+        {
+            decoded = makeMessage<M>(input.data(), input.size());
+        }
+        catch (const ReadyTraderGoError&)
+        {
+            if (input.size() >= size)
+                fail(name, "rejected " + std::to_string(input.size()) + " byte input");
+            continue;
+        }
+
+        if (input.size() < size)
+        {
+            fail(name, "accepted truncated " + std::to_string(input.size()) + " byte input");
+            continue;
+        }
+
+        const auto once = serialise(decoded);
+        const auto twice = serialise(makeMessage<M>(once.data(), once.size()));
+        const Bytes prefix(input.begin(), input.begin() + size);
+        const auto exact = serialise(makeMessage<M>(prefix.data(), prefix.size()));
+        if (once != twice || once != exact)
+        {
+            fail(name, "unstable decoding of " + toHex(input));
+            break;
+        }
+    }
+
+    // 4. Throughput.
+    std::vector<M> messages(64);
+    for (auto& m : messages)
+        m = randomMessage<M>();
+    Bytes buffer(size * messages.size());
+    for (std::size_t i = 0; i < messages.size(); ++i)
+        messages[i].Serialise(buffer.data() + i * size);
+
+    const double serialiseNs = runBenchmark(std::string("  ") + name + " serialise", THROUGHPUT_ITERATIONS,
+                                            [&](std::size_t i) {
+        const auto n = i & (messages.size() - 1);
+        messages[n].Serialise(buffer.data() + n * size);
+        doNotOptimise(buffer[n * size]);
+    });
+    const double deserialiseNs = runBenchmark(std::string("  ") + name + " deserialise", THROUGHPUT_ITERATIONS,
+                                              [&](std::size_t i) {
+        const auto n = i & (messages.size() - 1);
+        auto m = makeMessage<M>(buffer.data() + n * size, size);
+        doNotOptimise(m);
+    });
+    std::cout << "    " << static_cast<unsigned long>(1e9 / serialiseNs) << " serialised/s, "
+              << static_cast<unsigned long>(1e9 / deserialiseNs) << " deserialised/s" << std::endl;
+}
+
+int main()
+{
+    const Prices p1{1, 2, 3, 4, 5};
+    const Prices p2{0x01020304, 0, 0xFFFFFFFF, 7, 0x100};
+
+    checkMessage("AMEND_ORDER", AmendMessage{0x01020304, 10}, "010203040000000a");
+    checkMessage("CANCEL_ORDER", CancelMessage{0xA0B0C0D0}, "a0b0c0d0");
+    checkMessage("ERROR_MESSAGE", ErrorMessage{7, "bad"},
+                 "00000007626164" + std::string((MessageFieldSize::STRING - 3) * 2, '0'));
+    checkMessage("HEDGE_ORDER", HedgeMessage{1, Side::BUY, 12300, 5},
+                 "00000001" "01" "0000300c" "00000005");
+    checkMessage("HEDGE_FILLED", HedgeFilledMessage{2, 12300, 5}, "00000002" "0000300c" "00000005");
+    checkMessage("INSERT_ORDER", InsertMessage{3, Side::SELL, 12400, 10, Lifespan::GOOD_FOR_DAY},
+                 "00000003" "00" "00003070" "0000000a" "01");
+    checkMessage("LOGIN", LoginMessage{"ab", "c"},
+                 "6162" + std::string((MessageFieldSize::STRING - 2) * 2, '0')
+                 + "63" + std::string((MessageFieldSize::STRING - 1) * 2, '0'));
+    checkMessage("ORDER_BOOK_UPDATE", OrderBookMessage{Instrument::ETF, 9, p1, p2, p1, p2},
+                 "01" "00000009"
+                 "0000000100000002000000030000000400000005"
+                 "0102030400000000ffffffff0000000700000100"
+                 "0000000100000002000000030000000400000005"
+                 "0102030400000000ffffffff0000000700000100");
+    checkMessage("ORDER_FILLED", OrderFilledMessage{4, 12500, 1}, "00000004" "000030d4" "00000001");
+    checkMessage("ORDER_STATUS", OrderStatusMessage{5, 3, 7, -2},
+                 "00000005" "00000003" "00000007" "fffffffe");
+    checkMessage("TRADE_TICKS", TradeTicksMessage{Instrument::FUTURE, 0x10000, p2, p1, p2, p1},
+                 "00" "00010000"
+                 "0102030400000000ffffffff0000000700000100"
+                 "0000000100000002000000030000000400000005"
+                 "0102030400000000ffffffff0000000700000100"
+                 "0000000100000002000000030000000400000005");
+
+    if (gFailures != 0)
+    {
+        std::cout << gFailures << " propert" << (gFailures == 1 ? "y" : "ies") << " did not hold" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "all properties held" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,243 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <ready_trader_go/messagebudget.h>
+#include <ready_trader_go/quotediff.h>
+
+#include "benchmark.h"
+
+using namespace ReadyTraderGo;
+
+// Property checks for the quote differ and the message budget:
+//   1. moving a ladder by one level costs the messages the documentation in
+//      quotediff.h says it does, with and without a volume increment;
+//   2. a side that is out of order slots still reaches its target volumes;
+//   3. the message budget counts the same interval as the exchange; and
+//   4. the throughput of a one-level move is reported.
+// The process exits with a failure status if any property does not hold.
+
+constexpr std::size_t THROUGHPUT_ITERATIONS = 2000000;
+constexpr unsigned long TICK = 100;
+constexpr std::size_t MAX_ORDERS = 5;
+
+static std::size_t gFailures = 0;
+
+static void fail(const std::string& name, const std::string& what)
+{
+    std::cout << "FAILED: " << name << ": " << what << std::endl;
+    ++gFailures;
+}
+
+// Bids of 'levels' levels from 'best' down, of 'lot' plus 'increment' per
+// level away from the best price.
+static QuoteLevels ladder(unsigned long best, std::size_t levels, unsigned long lot, unsigned long increment)
+{
+    QuoteLevels result{};
+    for (std::size_t i = 0; i < levels; ++i)
+        result[i] = {best - i * TICK, lot + i * increment};
+    return result;
+}
+
+// Live orders as a simulated exchange would hold them after the actions.
+class Book
+{
+public:
+    void Apply(const QuoteDiffer::Actions& actions, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto& action = actions[i];
+            switch (action.mType)
+            {
+            case QuoteActionType::CANCEL:
+                Erase(action.mClientOrderId);
+                break;
+            case QuoteActionType::AMEND:
+                for (auto& order : mOrders)
+                    if (order.mClientOrderId == action.mClientOrderId)
+                        order.mRemainingVolume = action.mVolume;
+                break;
+            case QuoteActionType::INSERT:
+                mOrders.push_back({++mNextId, action.mPrice, action.mVolume});
+                break;
+            }
+        }
+    }
+
+    // Volume resting at 'price'
+    unsigned long VolumeAt(unsigned long price) const
+    {
+        unsigned long result = 0;
+        for (const auto& order : mOrders)
+            result += (order.mPrice == price) ? order.mRemainingVolume : 0;
+        return result;
+    }
+
+    const LiveQuote* Data() const { return mOrders.data(); }
+    std::size_t Size() const { return mOrders.size(); }
+
+private:
+    void Erase(unsigned long clientOrderId)
+    {
+        for (auto it = mOrders.begin(); it != mOrders.end(); ++it)
+            if (it->mClientOrderId == clientOrderId)
+            {
+                mOrders.erase(it);
+                return;
+            }
+    }
+
+    // Oldest first, as Diff expects
+    std::vector<LiveQuote> mOrders;
+    unsigned long mNextId = 0;
+};
+
+struct Cost
+{
+    std::size_t mCancels = 0;
+    std::size_t mAmends = 0;
+    std::size_t mInserts = 0;
+};
+
+// Diff 'book' to 'target', apply the actions and check that every level
+// holds its target volume in no more than MAX_ORDERS orders.
+static Cost move(const std::string& name, QuoteDiffer& differ, Book& book, const QuoteLevels& target)
+{
+    QuoteDiffer::Actions actions;
+    const auto count = differ.Diff(target, book.Data(), book.Size(), actions, MAX_ORDERS);
+    Cost cost;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        cost.mCancels += actions[i].mType == QuoteActionType::CANCEL;
+        cost.mAmends += actions[i].mType == QuoteActionType::AMEND;
+        cost.mInserts += actions[i].mType == QuoteActionType::INSERT;
+    }
+    book.Apply(actions, count);
+
+    if (book.Size() > MAX_ORDERS)
+        fail(name, std::to_string(book.Size()) + " orders resting");
+    if (!differ.IsCovered())
+        fail(name, "not every level was covered");
+    for (const auto& level : target)
+        if (level.mVolume != 0 && book.VolumeAt(level.mPrice) != level.mVolume)
+            fail(name, std::to_string(book.VolumeAt(level.mPrice)) + " lots at " + std::to_string(level.mPrice)
+                           + ", expected " + std::to_string(level.mVolume));
+    return cost;
+}
+
+static void expectCost(const std::string& name, const Cost& cost, std::size_t cancels, std::size_t amends,
+                       std::size_t inserts)
+{
+    std::cout << "  " << name << ": " << cost.mCancels << " cancels, " << cost.mAmends << " amends, "
+              << cost.mInserts << " inserts" << std::endl;
+    if (cost.mCancels != cancels || cost.mAmends != amends || cost.mInserts != inserts)
+        fail(name, "expected " + std::to_string(cancels) + " cancels, " + std::to_string(amends) + " amends, "
+                       + std::to_string(inserts) + " inserts");
+}
+
+// 1. and 2. One-level moves of a three level ladder of 10 lots.
+static void checkMoves(unsigned long increment)
+{
+    const std::string name = "increment " + std::to_string(increment);
+    const unsigned long best = 10000;
+    QuoteDiffer differ;
+    Book book;
+    move(name + " first quote", differ, book, ladder(best, 3, 10, increment));
+    const auto down = move(name + " away from best", differ, book, ladder(best - TICK, 3, 10, increment));
+
+    QuoteDiffer upDiffer;
+    Book upBook;
+    move(name + " first quote", upDiffer, upBook, ladder(best, 3, 10, increment));
+    const auto up = move(name + " towards best", upDiffer, upBook, ladder(best + TICK, 3, 10, increment));
+    const auto back = move(name + " back again", upDiffer, upBook, ladder(best, 3, 10, increment));
+    if (increment == 0)
+    {
+        expectCost(name + " away from best", down, 1, 0, 1);
+        expectCost(name + " towards best", up, 1, 0, 1);
+        expectCost(name + " back again", back, 1, 0, 1);
+    }
+    else
+    {
+        // The two levels that move away hold too much and are amended down
+        expectCost(name + " away from best", down, 1, 2, 1);
+        // The two that move closer fall short, so a new best level and two
+        // top-ups: the side then has five orders
+        expectCost(name + " towards best", up, 1, 0, 3);
+        // Moving back, the top-ups are the surplus and are cancelled
+        expectCost(name + " back again", back, 3, 0, 1);
+    }
+
+    // Moving on towards the best price runs out of order slots, and a
+    // shortfall is then made up by replacing an order
+    for (unsigned long i = 1; i <= 4; ++i)
+        move(name + " on towards best", upDiffer, upBook, ladder(best + i * TICK, 3, 10, increment));
+}
+
+// 3. The exchange drops a message from its count only once it is more than
+// an interval old.
+static void checkBudget()
+{
+    using namespace std::chrono_literals;
+    const std::string name = "message budget";
+    MessageBudget budget;
+    const MessageBudget::Clock::time_point start{};
+
+    for (std::size_t i = 0; i < MESSAGE_FREQUENCY_LIMIT; ++i)
+        budget.Record(start + i * 10ms);
+    if (budget.Available(start + 500ms, MESSAGE_FREQUENCY_LIMIT) != 0)
+        fail(name, "messages available with the interval full");
+    if (budget.Count(start + 1000ms) != MESSAGE_FREQUENCY_LIMIT)
+        fail(name, "a message exactly an interval old was not counted");
+    if (budget.Count(start + 1001ms) != MESSAGE_FREQUENCY_LIMIT - 1)
+        fail(name, "a message more than an interval old was still counted");
+    if (budget.Available(start + 1250ms, MESSAGE_FREQUENCY_LIMIT) != MESSAGE_FREQUENCY_LIMIT / 2)
+        fail(name, "wrong messages available a quarter interval on");
+    if (budget.Count(start + 10s) != 0)
+        fail(name, "messages still counted long after");
+}
+
+int main()
+{
+    std::cout << "one-level moves of a three level ladder:" << std::endl;
+    checkMoves(0);
+    checkMoves(5);
+    checkBudget();
+
+    // 4. Throughput.
+    QuoteDiffer differ;
+    Book book;
+    move("throughput", differ, book, ladder(10000, 3, 10, 5));
+    const auto target = ladder(10100, 3, 10, 5);
+    QuoteDiffer::Actions actions;
+    runBenchmark("  Diff of a one-level move", THROUGHPUT_ITERATIONS, [&](std::size_t) {
+        doNotOptimise(differ.Diff(target, book.Data(), book.Size(), actions, MAX_ORDERS));
+    });
+
+    if (gFailures != 0)
+    {
+        std::cout << gFailures << " propert" << (gFailures == 1 ? "y" : "ies") << " did not hold" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
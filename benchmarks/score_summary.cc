@@ -0,0 +1,175 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <ready_trader_go/error.h>
+#include <simulator/scoreboard.h>
+
+using namespace ReadyTraderGo;
+
+// Summarises the score boards written by bench_backtest --scores, e.g. from
+// a sweep of latencies or parameters, one line for each argument.
+//
+// Usage: score_summary [--runs] FILE OR DIRECTORY...
+// A directory stands for every .score file in it. With --runs each score
+// board is also summarised on its own.
+
+using Clock = std::chrono::steady_clock;
+
+static std::vector<std::string> scoreFiles(const std::string& argument)
+{
+    std::vector<std::string> files;
+    if (!std::filesystem::is_directory(argument))
+    {
+        files.push_back(argument);
+        return files;
+    }
+    for (const auto& entry : std::filesystem::directory_iterator(argument))
+    {
+        if (entry.path().extension() == ".score")
+            files.push_back(entry.path().string());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+static double dollars(double cents)
+{
+    return cents / 100.0;
+}
+
+static void reportRun(const std::string& name, const ScoreSummary& summary)
+{
+    std::cout << "  " << name << ": pnl=" << dollars(summary.mProfitOrLoss)
+              << " max=" << dollars(summary.mMaxProfit)
+              << " min=" << dollars(summary.mMinProfitOrLoss)
+              << " drawdown=" << dollars(summary.mMaxDrawdown)
+              << " fees=" << dollars(summary.mTotalFees)
+              << " etf volume=" << summary.mEtfVolume
+              << " unhedged=" << summary.mMaxUnhedgedLots;
+    if (summary.mBreached)
+        std::cout << " BREACH at " << summary.mBreachTime << "s";
+    std::cout << std::endl;
+}
+
+static void reportGroup(const std::string& name, std::vector<ScoreSummary>& summaries)
+{
+    if (summaries.empty())
+    {
+        std::cout << name << ": no score boards" << std::endl;
+        return;
+    }
+
+    std::sort(summaries.begin(), summaries.end(), [](const ScoreSummary& a, const ScoreSummary& b) {
+        return a.mProfitOrLoss < b.mProfitOrLoss;
+    });
+    const double count = static_cast<double>(summaries.size());
+    double total = 0.0;
+    double drawdown = 0.0;
+    double fees = 0.0;
+    std::size_t breaches = 0;
+    for (const auto& summary : summaries)
+    {
+        total += summary.mProfitOrLoss;
+        drawdown += summary.mMaxDrawdown;
+        fees += summary.mTotalFees;
+        breaches += summary.mBreached ? 1 : 0;
+    }
+    const double mean = total / count;
+    double variance = 0.0;
+    for (const auto& summary : summaries)
+        variance += (summary.mProfitOrLoss - mean) * (summary.mProfitOrLoss - mean);
+    auto percentile = [&](double p) {
+        return summaries[std::min(summaries.size() - 1, static_cast<std::size_t>(p * count))].mProfitOrLoss;
+    };
+
+    std::cout << name << ": runs=" << summaries.size()
+              << " pnl mean=" << dollars(mean)
+              << " sd=" << dollars(std::sqrt(variance / count))
+              << " min=" << dollars(summaries.front().mProfitOrLoss)
+              << " p10=" << dollars(percentile(0.1))
+              << " p50=" << dollars(percentile(0.5))
+              << " p90=" << dollars(percentile(0.9))
+              << " max=" << dollars(summaries.back().mProfitOrLoss)
+              << " drawdown mean=" << dollars(drawdown / count)
+              << " fees mean=" << dollars(fees / count)
+              << " breaches=" << breaches << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    bool runs = false;
+    std::vector<std::string> arguments;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--runs")
+            runs = true;
+        else
+            arguments.push_back(arg);
+    }
+    if (arguments.empty())
+    {
+        std::cerr << "usage: " << argv[0] << " [--runs] FILE OR DIRECTORY..." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    const auto start = Clock::now();
+    std::vector<ScoreRecord> records;
+    std::vector<ScoreSummary> all;
+    std::size_t recordCount = 0;
+    for (const auto& argument : arguments)
+    {
+        std::vector<ScoreSummary> summaries;
+        try
+        {
+            for (const auto& file : scoreFiles(argument))
+            {
+                readScoreBoard(file, records);
+                recordCount += records.size();
+                summaries.push_back(summariseScores(records));
+                if (runs)
+                    reportRun(file, summaries.back());
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        all.insert(all.end(), summaries.begin(), summaries.end());
+        reportGroup(argument, summaries);
+    }
+    if (arguments.size() > 1)
+        reportGroup("all", all);
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "read " << all.size() << " score boards (" << recordCount << " records) in "
+              << std::setprecision(3) << seconds << "s" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,137 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/log/core.hpp>
+
+#include <ready_trader_go/connectivity.h>
+#include <ready_trader_go/protocol.h>
+
+using namespace ReadyTraderGo;
+using boost::asio::ip::tcp;
+
+// Measures the round-trip latency of the execution connection against a
+// local echo server standing in for the exchange, with each socket option
+// and the busy-poll mode turned on in turn.
+
+constexpr std::size_t WARM_UP = 500;
+constexpr std::size_t ROUND_TRIPS = 10000;
+
+struct Scenario
+{
+    std::string mName;
+    SocketOptions mOptions;
+};
+
+// Accept one connection and echo everything received until it is closed.
+static void echoServer(tcp::acceptor& acceptor)
+{
+    boost::asio::io_context context;
+    tcp::socket peer{context};
+    acceptor.accept(peer);
+    peer.set_option(tcp::no_delay(true));
+    unsigned char buf[4096];
+    boost::system::error_code error;
+    for (;;)
+    {
+        const std::size_t size = peer.read_some(boost::asio::buffer(buf), error);
+        if (error)
+            return;
+        boost::asio::write(peer, boost::asio::buffer(buf, size), error);
+    }
+}
+
+static void runScenario(const Scenario& scenario)
+{
+    boost::asio::io_context context;
+    tcp::acceptor acceptor{context, tcp::endpoint{boost::asio::ip::address_v4::loopback(), 0}};
+    std::thread server{echoServer, std::ref(acceptor)};
+
+    ConnectionFactory factory{context, "127.0.0.1", acceptor.local_endpoint().port(), scenario.mOptions};
+    std::vector<double> latencies;
+    latencies.reserve(ROUND_TRIPS);
+    {
+        auto connection = factory.Create();
+        std::size_t received = 0;
+        connection->MessageReceived = [&received](IConnection*, unsigned char, unsigned char const*, std::size_t) {
+            ++received;
+        };
+        connection->AsyncRead();
+
+        const InsertMessage insert{1, Side::BUY, 10000, 10, Lifespan::GOOD_FOR_DAY};
+        for (std::size_t i = 0; i < WARM_UP + ROUND_TRIPS; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            connection->SendMessage(MessageType::INSERT_ORDER, insert);
+            while (received <= i)
+                context.run_one();
+            const auto finish = std::chrono::steady_clock::now();
+            if (i >= WARM_UP)
+                latencies.push_back(std::chrono::duration<double, std::micro>(finish - start).count());
+        }
+    }
+    server.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << std::left << std::setw(28) << scenario.mName << std::right << std::fixed << std::setprecision(2)
+              << " median " << std::setw(8) << latencies[latencies.size() / 2] << " us"
+              << "  p99 " << std::setw(8) << latencies[latencies.size() * 99 / 100] << " us";
+    for (auto& result : factory.GetSocketOptionResults())
+    {
+        std::cout << "  " << result.mName << (result.mApplied ? " applied" : " NOT applied");
+    }
+    std::cout << std::endl;
+}
+
+int main()
+{
+    boost::log::core::get()->set_logging_enabled(false);
+
+    std::vector<Scenario> scenarios(7);
+    scenarios[0].mName = "defaults";
+    scenarios[1].mName = "busy-poll mode";
+    scenarios[1].mOptions.mBusyPollMode = true;
+    scenarios[2].mName = "SO_BUSY_POLL=50";
+    scenarios[2].mOptions.mBusyPollMicroseconds = 50;
+    scenarios[3].mName = "SO_RCVBUF/SO_SNDBUF=256KiB";
+    scenarios[3].mOptions.mReceiveBufferSize = 256 * 1024;
+    scenarios[3].mOptions.mSendBufferSize = 256 * 1024;
+    scenarios[4].mName = "TCP_QUICKACK";
+    scenarios[4].mOptions.mQuickAck = true;
+    scenarios[5].mName = "SO_RCVLOWAT=3";
+    scenarios[5].mOptions.mReceiveLowWatermark = MESSAGE_HEADER_SIZE;
+    scenarios[6].mName = "all of the above";
+    scenarios[6].mOptions = {true, 50, 256 * 1024, 256 * 1024, true, MESSAGE_HEADER_SIZE};
+
+    for (auto& scenario : scenarios)
+    {
+        runScenario(scenario);
+    }
+
+    return 0;
+}
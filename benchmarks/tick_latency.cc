@@ -0,0 +1,269 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define BOOST_BIND_GLOBAL_PLACEHOLDERS
+#include <boost/asio/io_context.hpp>
+#include <boost/log/core.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <ready_trader_go/bookstate.h>
+#include <ready_trader_go/error.h>
+#include <ready_trader_go/protocol.h>
+#include <ready_trader_go/timerservice.h>
+#include <simulator/marketdata.h>
+#include <simulator/marketreplay.h>
+#include <simulator/recordingconnection.h>
+
+#include "autotrader.h"
+
+using namespace ReadyTraderGo;
+
+// Replays market data files through the autotrader, in-process and as fast
+// as possible, and reports how long its order book and trade ticks handlers
+// take. The execution connection only records what is sent and answers it
+// with the order status the exchange would, so the autotrader never sees a
+// fill. This is also the training workload for
+// profile-guided builds (see the 'pgo-train' target).
+//
+// Usage: bench_tick_latency [--config JSON FILE] [MARKET DATA FILE...]
+// With no data files every data/market_data*.csv file is replayed. The
+// autotrader's "Parameters" are read from the configuration file, if given.
+
+#ifndef RTG_DATA_DIR
+#define RTG_DATA_DIR "data"
+#endif
+
+#ifndef RTG_BUILD_MODE
+#define RTG_BUILD_MODE "unknown"
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+static std::vector<std::string> defaultDataFiles()
+{
+    std::vector<std::string> files;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(RTG_DATA_DIR, error))
+    {
+        const auto name = entry.path().filename().string();
+        if (name.rfind("market_data", 0) == 0 && entry.path().extension() == ".csv")
+            files.push_back(entry.path().string());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+static void report(const std::string& name, std::vector<std::uint32_t>& latencies)
+{
+    if (latencies.empty())
+    {
+        std::cout << std::left << std::setw(24) << name << "no samples" << std::endl;
+        return;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+        return latencies[std::min(latencies.size() - 1, static_cast<std::size_t>(p * latencies.size()))];
+    };
+    double total = 0.0;
+    for (auto latency : latencies)
+        total += latency;
+
+    std::cout << std::left << std::setw(24) << name << std::right
+              << " n=" << std::setw(8) << latencies.size()
+              << " mean=" << std::setw(8) << std::fixed << std::setprecision(1) << total / latencies.size()
+              << " p50=" << std::setw(6) << percentile(0.50)
+              << " p90=" << std::setw(6) << percentile(0.90)
+              << " p99=" << std::setw(7) << percentile(0.99)
+              << " p99.9=" << std::setw(7) << percentile(0.999)
+              << " max=" << std::setw(8) << latencies.back() << " (ns)" << std::endl;
+}
+
+template<typename F>
+static void timeCall(std::vector<std::uint32_t>& latencies, F&& call)
+{
+    const auto start = Clock::now();
+    call();
+    const auto finish = Clock::now();
+    latencies.push_back(static_cast<std::uint32_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count()));
+}
+
+int main(int argc, char* argv[])
+{
+    boost::log::core::get()->set_logging_enabled(false);
+
+    std::vector<std::string> files(argv + 1, argv + argc);
+    boost::property_tree::ptree config;
+    if (files.size() >= 2 && files[0] == "--config")
+    {
+        try
+        {
+            boost::property_tree::read_json(files[1], config);
+        }
+        catch (const boost::property_tree::ptree_error& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        files.erase(files.begin(), files.begin() + 2);
+    }
+    if (files.empty())
+        files = defaultDataFiles();
+    if (files.empty())
+    {
+        std::cerr << "no market data files found in " << RTG_DATA_DIR << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "build mode: " << RTG_BUILD_MODE << std::endl
+              << "book delta kernel: " << BookDeltaKernelName() << std::endl;
+
+    std::vector<std::uint32_t> bookLatencies;
+    std::vector<std::uint32_t> ticksLatencies;
+
+    for (const auto& file : files)
+    {
+        std::vector<MarketEvent> events;
+        try
+        {
+            events = readMarketData(file);
+        }
+        catch (const ReadyTraderGoError& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        boost::asio::io_context context;
+        AutoTrader trader{context};
+        try
+        {
+            trader.LoadParameters(config);
+        }
+        catch (const ReadyTraderGoError& e)
+        {
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        auto connection = std::make_unique<RecordingConnection>();
+        auto* recorder = connection.get();
+        trader.SetExecutionConnection(std::move(connection));
+
+        // Nothing ever trades here, so answer each request with the order
+        // status the exchange would send once the handler that made it has
+        // returned: inserts rest with all their volume (or, fill-and-kill,
+        // are killed), amends leave the new volume and cancels close
+        struct Status
+        {
+            unsigned long mClientOrderId;
+            unsigned long mRemainingVolume;
+        };
+        std::vector<Status> statuses;
+        recorder->MessageSent = [&](unsigned char type, unsigned char const* data, std::size_t size) {
+            switch (type)
+            {
+            case MessageType::INSERT_ORDER:
+            {
+                const auto insert = makeMessage<InsertMessage>(data, size);
+                statuses.push_back({insert.mClientOrderId,
+                                    insert.mLifespan == Lifespan::FILL_AND_KILL ? 0 : insert.mVolume});
+                break;
+            }
+            case MessageType::AMEND_ORDER:
+            {
+                const auto amend = makeMessage<AmendMessage>(data, size);
+                statuses.push_back({amend.mClientOrderId, amend.mNewVolume});
+                break;
+            }
+            case MessageType::CANCEL_ORDER:
+                statuses.push_back({makeMessage<CancelMessage>(data, size).mClientOrderId, 0});
+                break;
+            default:
+                break;
+            }
+        };
+        auto reportStatuses = [&] {
+            unsigned char status[OrderStatusMessage::Schema::SIZE];
+            // Handling a status may send more requests
+            for (std::size_t i = 0; i < statuses.size(); ++i)
+            {
+                const auto [clientOrderId, remainingVolume] = statuses[i];
+                OrderStatusMessage::Schema::Serialise(OrderStatusMessage{clientOrderId, 0, remainingVolume, 0},
+                                                      status);
+                recorder->Receive(MessageType::ORDER_STATUS, status, sizeof(status));
+            }
+            statuses.clear();
+        };
+
+        // Run the trader's timers, and so its message budget, in the replay's
+        // time rather than at the rate the replay happens to run
+        auto& timers = trader.GetTimers();
+        const auto timerStart = TimerService::Clock::now();
+        timers.AdvanceTo(timerStart);
+
+        MarketReplay replay{events};
+        auto advanceTimers = [&] {
+            timers.AdvanceTo(timerStart + std::chrono::duration_cast<TimerService::Clock::duration>(
+                                              std::chrono::duration<double>(replay.GetTime())));
+        };
+        replay.OrderBookUpdated = [&](const OrderBookMessage& book) {
+            advanceTimers();
+            timeCall(bookLatencies, [&] { trader.DeliverOrderBook(book); });
+            reportStatuses();
+        };
+        replay.TradeTicksOccurred = [&](const TradeTicksMessage& ticks) {
+            advanceTimers();
+            timeCall(ticksLatencies, [&] { trader.DeliverTradeTicks(ticks); });
+            reportStatuses();
+        };
+
+        const auto start = Clock::now();
+        replay.Run();
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::cout << file << ": " << events.size() << " events, " << replay.GetTickNumber() - 1 << " ticks in "
+                  << std::setprecision(2) << seconds << "s; sent "
+                  << recorder->GetSentCount(MessageType::INSERT_ORDER) << " inserts, "
+                  << recorder->GetSentCount(MessageType::CANCEL_ORDER) << " cancels, "
+                  << recorder->GetSentCount(MessageType::AMEND_ORDER) << " amends, "
+                  << trader.GetQuoteDiffStats().mMessagesAvoided << " avoided, "
+                  << trader.GetSelfTradesPrevented() << " self-trades prevented" << std::endl;
+
+        const auto& taker = trader.GetTakerLatency();
+        std::cout << "  " << taker.Count() << " fill-and-kill orders, book to order p50="
+                  << taker.Percentile(0.5) << " p99=" << taker.Percentile(0.99) << " max=" << taker.Max()
+                  << " (ns)" << std::endl;
+    }
+
+    report("order book handler", bookLatencies);
+    report("trade ticks handler", ticksLatencies);
+    return EXIT_SUCCESS;
+}
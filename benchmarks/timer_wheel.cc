@@ -0,0 +1,235 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <ready_trader_go/timerwheel.h>
+
+using namespace ReadyTraderGo;
+
+// Checks the timer wheel against the expiry times it was given, over
+// simulated time, then compares the cost of scheduling and cancelling a timer
+// with that of an Asio steady_timer. Exits with a failure status if a timer
+// fires early, late, twice or not at all, or if the wheel allocates.
+
+static std::atomic<bool> gCounting{false};
+static std::atomic<std::size_t> gAllocations{0};
+
+void* operator new(std::size_t size)
+{
+    if (gCounting.load(std::memory_order_relaxed))
+        gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+using Clock = TimerWheel::Clock;
+using BenchClock = std::chrono::steady_clock;
+
+constexpr std::size_t TIMER_COUNT = 4096;
+constexpr std::size_t CHECK_STEPS = 2000000;
+constexpr std::size_t ITERATIONS = 1000000;
+constexpr Clock::duration RESOLUTION = std::chrono::milliseconds(1);
+
+struct CheckedTimer
+{
+    CheckedTimer() : mTimer(WheelTimer::Calling<&CheckedTimer::Fire>(this)) {}
+
+    void Fire()
+    {
+        ++mFired;
+        if (*mNow < mDue || *mPrevious >= mLatest)
+            ++mMistimed;
+    }
+
+    WheelTimer mTimer;
+    const Clock::time_point* mNow = nullptr;
+    const Clock::time_point* mPrevious = nullptr;
+    Clock::time_point mDue;
+    // The timer is late if the wheel was advanced to this time without it
+    Clock::time_point mLatest;
+    std::size_t mExpected = 0;
+    std::size_t mFired = 0;
+    std::size_t mMistimed = 0;
+};
+
+// Random schedules, reschedules and cancellations, from the next tick to
+// beyond the wheel's range, while time advances in uneven steps.
+static bool check()
+{
+    std::mt19937_64 random{42};
+    const Clock::time_point start{};
+    TimerWheel wheel{RESOLUTION, start};
+    Clock::time_point now = start;
+    Clock::time_point previous = start;
+    std::vector<CheckedTimer> timers(TIMER_COUNT);
+    for (auto& timer : timers)
+    {
+        timer.mNow = &now;
+        timer.mPrevious = &previous;
+    }
+    auto tickOf = [&](Clock::time_point when, bool roundUp) {
+        return ((when - start) + (roundUp ? RESOLUTION - Clock::duration(1) : Clock::duration::zero())) / RESOLUTION;
+    };
+
+    const std::int64_t spans[] = {2, 64, 4096, 262144, 16777216, 100000000};
+    std::size_t expected = 0;
+    for (std::size_t step = 0; step < CHECK_STEPS; ++step)
+    {
+        auto& timer = timers[random() % TIMER_COUNT];
+        if (random() % 8 == 0)
+        {
+            if (timer.mTimer.IsScheduled())
+            {
+                wheel.Cancel(timer.mTimer);
+                --timer.mExpected;
+                --expected;
+            }
+        }
+        else
+        {
+            if (!timer.mTimer.IsScheduled())
+            {
+                ++timer.mExpected;
+                ++expected;
+            }
+            const auto span = spans[random() % std::size(spans)];
+            const auto delay = Clock::duration(static_cast<Clock::rep>(random() % (span * RESOLUTION.count())));
+            timer.mDue = now + delay;
+            timer.mLatest = start + RESOLUTION * std::max(tickOf(timer.mDue, true), tickOf(now, false) + 1);
+            wheel.Schedule(timer.mTimer, timer.mDue);
+        }
+        previous = now;
+        now += Clock::duration(static_cast<Clock::rep>(random() % (3 * RESOLUTION.count())));
+        wheel.Advance(now);
+    }
+
+    while (!wheel.IsEmpty())
+    {
+        previous = now;
+        now = std::max(now + RESOLUTION, wheel.NextTick());
+        wheel.Advance(now);
+    }
+
+    std::size_t fired = 0;
+    std::size_t mistimed = 0;
+    std::size_t miscounted = 0;
+    for (const auto& timer : timers)
+    {
+        fired += timer.mFired;
+        mistimed += timer.mMistimed;
+        miscounted += timer.mFired != timer.mExpected;
+    }
+    std::cout << "check: " << CHECK_STEPS << " operations, " << fired << " of " << expected << " timers fired, "
+              << mistimed << " mistimed, " << miscounted << " miscounted" << std::endl;
+    return fired == expected && mistimed == 0 && miscounted == 0;
+}
+
+template<typename F>
+static double nanosecondsPer(std::size_t iterations, F&& step)
+{
+    const auto start = BenchClock::now();
+    for (std::size_t i = 0; i < iterations; ++i)
+        step(i);
+    return std::chrono::duration<double, std::nano>(BenchClock::now() - start).count() / iterations;
+}
+
+static void noop()
+{
+}
+
+int main()
+{
+    const bool correct = check();
+
+    // A wheel holding many timers, as the trader's would, with one more
+    // scheduled and cancelled (or moved) per iteration
+    TimerWheel wheel{RESOLUTION};
+    std::vector<std::unique_ptr<WheelTimer>> background;
+    for (std::size_t i = 0; i < TIMER_COUNT; ++i)
+    {
+        background.push_back(std::make_unique<WheelTimer>([](void*) {}, nullptr));
+        wheel.ScheduleAfter(*background.back(), std::chrono::milliseconds(1 + i * 7 % 60000));
+    }
+    WheelTimer timer{[](void*) {}, nullptr};
+
+    gAllocations = 0;
+    gCounting = true;
+    const double wheelScheduleCancel = nanosecondsPer(ITERATIONS, [&](std::size_t i) {
+        wheel.ScheduleAfter(timer, std::chrono::milliseconds(1 + i % 30000));
+        wheel.Cancel(timer);
+    });
+    const double wheelReschedule = nanosecondsPer(ITERATIONS, [&](std::size_t i) {
+        wheel.ScheduleAfter(timer, std::chrono::milliseconds(1 + i % 30000));
+    });
+    auto now = Clock::now();
+    const double wheelAdvance = nanosecondsPer(ITERATIONS / 100, [&](std::size_t) {
+        now += RESOLUTION;
+        wheel.Advance(now);
+    });
+    const double clockRead = nanosecondsPer(ITERATIONS, [&](std::size_t) {
+        now = std::max(now, Clock::now());
+    });
+    gCounting = false;
+    const std::size_t wheelAllocations = gAllocations;
+
+    boost::asio::io_context context;
+    boost::asio::steady_timer steadyTimer{context};
+    const double asioScheduleCancel = nanosecondsPer(ITERATIONS, [&](std::size_t i) {
+        steadyTimer.expires_after(std::chrono::milliseconds(1 + i % 30000));
+        steadyTimer.async_wait([](auto&) { noop(); });
+        steadyTimer.cancel();
+        context.poll();
+        context.restart();
+    });
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "timer wheel schedule+cancel: " << wheelScheduleCancel << " ns" << std::endl
+              << "timer wheel reschedule:      " << wheelReschedule << " ns" << std::endl
+              << "timer wheel advance 1 tick:  " << wheelAdvance << " ns (" << TIMER_COUNT << " timers)"
+              << std::endl
+              << "coarse clock read:           " << clockRead << " ns" << std::endl
+              << "steady_timer wait+cancel:    " << asioScheduleCancel << " ns" << std::endl
+              << "timer wheel allocations:     " << wheelAllocations << std::endl;
+
+    return (correct && wheelAllocations == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
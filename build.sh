@@ -1,11 +1,39 @@
 #!/usr/bin/env bash
 
-if [[ $# -ne 1 ]]; then
-  echo "Usage: $0 [ Release | Debug ]"
+if [[ $# -lt 1 ]]; then
+  echo "Usage: $0 [ Release | Debug ] [ lto ] [ pgo ] [ native ]"
   exit
 fi
 
-cmake -DCMAKE_BUILD_TYPE=$1 -B build
-cmake --build build --config $1
+build_type=$1
+shift
 
-cp build/autotrader .
+build_dir=build
+options=()
+pgo=0
+for mode in "$@"; do
+  case $mode in
+    lto) options+=(-DRTG_LTO=ON) ;;
+    pgo) pgo=1 ;;
+    native) options+=(-DRTG_MARCH=native) ;;
+    *) echo "Unknown build mode: $mode"; exit 1 ;;
+  esac
+  build_dir=$build_dir-$mode
+done
+
+set -e
+
+if [[ $pgo -eq 1 ]]; then
+  # Profiles are keyed by object file path, so the instrumented and
+  # optimised builds must share a build directory.
+  cmake -DCMAKE_BUILD_TYPE=$build_type "${options[@]}" -DRTG_PGO=GENERATE -B $build_dir
+  cmake --build $build_dir --config $build_type --target pgo-train
+  options+=(-DRTG_PGO=USE)
+else
+  options+=(-DRTG_PGO=OFF)
+fi
+
+cmake -DCMAKE_BUILD_TYPE=$build_type "${options[@]}" -B $build_dir
+cmake --build $build_dir --config $build_type
+
+cp $build_dir/autotrader .
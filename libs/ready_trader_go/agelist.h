@@ -0,0 +1,105 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_AGELIST_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_AGELIST_H
+
+namespace ReadyTraderGo {
+
+template<typename T> class AgeList;
+
+// Embedded in an object to keep it in an AgeList. An object leaves its list
+// when it is destroyed, so it may be erased from whatever container owns it
+// without the list being told. Copies start out of any list, and assignment
+// leaves the target's place in its list alone.
+template<typename T>
+class AgeListHook
+{
+public:
+    AgeListHook() noexcept = default;
+    AgeListHook(const AgeListHook&) noexcept {}
+    AgeListHook& operator=(const AgeListHook&) noexcept { return *this; }
+    ~AgeListHook() { Unlink(); }
+
+    bool IsLinked() const noexcept { return mNext != nullptr; }
+
+    void Unlink() noexcept
+    {
+        if (mNext != nullptr)
+        {
+            mPrevious->mNext = mNext;
+            mNext->mPrevious = mPrevious;
+            mPrevious = mNext = nullptr;
+        }
+    }
+
+private:
+    friend class AgeList<T>;
+
+    AgeListHook* mPrevious = nullptr;
+    AgeListHook* mNext = nullptr;
+    T* mOwner = nullptr;
+};
+
+// An intrusive list of objects in the order they were added, oldest first.
+// Objects added in order of age (e.g. as they are created) can be expired
+// from the front in time proportional to the number expired, however many
+// there are. Adding and removing are O(1) and never allocate.
+template<typename T>
+class AgeList
+{
+public:
+    using Hook = AgeListHook<T>;
+
+    AgeList() noexcept { mHead.mPrevious = mHead.mNext = &mHead; }
+    ~AgeList() { Clear(); }
+
+    AgeList(const AgeList&) = delete;
+    void operator=(const AgeList&) = delete;
+
+    bool IsEmpty() const noexcept { return mHead.mNext == &mHead; }
+
+    // The oldest object, or nullptr if the list is empty.
+    T* Front() const noexcept { return IsEmpty() ? nullptr : mHead.mNext->mOwner; }
+
+    // Add an object, through its hook, as the newest. An object already in a
+    // list is moved.
+    void PushBack(T& object, Hook& hook) noexcept
+    {
+        hook.Unlink();
+        hook.mOwner = &object;
+        hook.mPrevious = mHead.mPrevious;
+        hook.mNext = &mHead;
+        mHead.mPrevious->mNext = &hook;
+        mHead.mPrevious = &hook;
+    }
+
+    void Clear() noexcept
+    {
+        while (!IsEmpty())
+            mHead.mNext->Unlink();
+    }
+
+private:
+    // Sentinel: the list is circular through it, so unlinking needs no
+    // reference to the list
+    Hook mHead;
+};
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_AGELIST_H
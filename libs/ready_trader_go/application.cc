@@ -70,6 +70,11 @@ Application::~Application()
 }
 
 void Application::LoadConfig(const std::string& filename)
+{
+    OnConfigLoaded(ReadConfig(filename));
+}
+
+boost::property_tree::ptree Application::ReadConfig(const std::string& filename)
 {
     boost::property_tree::ptree tree;
 
@@ -86,7 +91,25 @@ void Application::LoadConfig(const std::string& filename)
         throw ReadyTraderGoError("failed while reading configuration file: '" + filename + "': " + err.message());
     }
 
-    OnConfigLoaded(tree);
+    return tree;
+}
+
+// A configuration that cannot be read or applied is reported and otherwise
+// ignored, leaving the application running with its current settings.
+void Application::ReloadConfig()
+{
+    try
+    {
+        OnConfigReloaded(ReadConfig(mName + ".json"));
+    }
+    catch (const ReadyTraderGoError& err)
+    {
+        RLOG(LG_APP, LogLevel::LL_ERROR) << "configuration not reloaded: " << err.what();
+    }
+    catch (const boost::property_tree::ptree_error& err)
+    {
+        RLOG(LG_APP, LogLevel::LL_ERROR) << "configuration not reloaded: " << err.what();
+    }
 }
 
 void Application::Run(int argc, char* argv[])
@@ -111,12 +134,20 @@ void Application::Run(int argc, char* argv[])
 #ifdef SIGQUIT
     mSignals.add(SIGQUIT);
 #endif
-    mSignals.async_wait([this](const boost::system::error_code& ec, int s) { SignalHandler(ec, s); });
+#ifdef SIGHUP
+    mSignals.add(SIGHUP);
+#endif
+    AsyncWaitForSignal();
 
     OnReadyToRun();
     mContext.run();
 }
 
+void Application::AsyncWaitForSignal()
+{
+    mSignals.async_wait([this](const boost::system::error_code& ec, int s) { SignalHandler(ec, s); });
+}
+
 void Application::SetUpLogging()
 {
     std::string logFilename = mName + ".log";
@@ -149,6 +180,16 @@ void Application::SetUpLogging()
 
 void Application::SignalHandler(const boost::system::error_code& error, int signal)
 {
+#ifdef SIGHUP
+    if (!error && signal == SIGHUP)
+    {
+        RLOG(LG_APP, LogLevel::LL_INFO) << "application received signal " << signal << ", reloading configuration";
+        ReloadConfig();
+        AsyncWaitForSignal();
+        return;
+    }
+#endif
+
     if (!error)
     {
         RLOG(LG_APP, LogLevel::LL_INFO) << "application received signal " << signal << ", shutting down";
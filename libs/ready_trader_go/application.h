@@ -54,13 +54,20 @@ public:
     void Run(int argc, char* argv[]);
 
     std::function<void(const boost::property_tree::ptree&)> ConfigLoaded;
+    // Called when the configuration file is re-read, which happens when the
+    // application receives SIGHUP.
+    std::function<void(const boost::property_tree::ptree&)> ConfigReloaded;
     std::function<void()> ReadyToRun;
 
 private:
     void OnConfigLoaded(const boost::property_tree::ptree& tree) const;
+    void OnConfigReloaded(const boost::property_tree::ptree& tree) const;
     void OnReadyToRun() const;
 
     void LoadConfig(const std::string& filename);
+    boost::property_tree::ptree ReadConfig(const std::string& filename);
+    void ReloadConfig();
+    void AsyncWaitForSignal();
     void SetUpLogging();
     void SignalHandler(const boost::system::error_code& error, int signal);
     void TearDownLogging();
@@ -83,6 +90,14 @@ inline void Application::OnConfigLoaded(const boost::property_tree::ptree& tree)
     }
 }
 
+inline void Application::OnConfigReloaded(const boost::property_tree::ptree& tree) const
+{
+    if (ConfigReloaded)
+    {
+        ConfigReloaded(tree);
+    }
+}
+
 inline void Application::OnReadyToRun() const
 {
     if (ReadyToRun)
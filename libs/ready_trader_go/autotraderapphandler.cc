@@ -39,16 +39,19 @@ void AutoTraderAppHandler::ConfigLoadedHandler(const boost::property_tree::ptree
 
     mExecConnectionFactory = std::make_unique<ConnectionFactory>(mContext,
                                                                  config.mExecHost,
-                                                                 config.mExecPort);
+                                                                 config.mExecPort,
+                                                                 config.mExecSocketOptions);
     mInfoSubscriptionFactory = std::make_unique<SubscriptionFactory>(mContext,
                                                                      config.mInfoType,
                                                                      config.mInfoName);
 
     mAutoTrader.SetLoginDetails(config.mTeamName, config.mSecret);
+    mAutoTrader.LoadParameters(tree);
 }
 
 void AutoTraderAppHandler::ReadyToRunHandler()
 {
+    mAutoTrader.SetExecutionConnectionFactory(mExecConnectionFactory.get());
     auto connection = mExecConnectionFactory->Create();
     mAutoTrader.SetExecutionConnection(std::move(connection));
     auto subscription = mInfoSubscriptionFactory->Create();
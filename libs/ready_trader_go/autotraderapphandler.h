@@ -35,7 +35,10 @@ public:
         : mApplication(application), mAutoTrader(autoTrader), mContext(mApplication.GetContext())
     {
         mApplication.ConfigLoaded = [this](auto& tree) { ConfigLoadedHandler(tree); };
+        mApplication.ConfigReloaded = [this](auto& tree) { mAutoTrader.LoadParameters(tree); };
         mApplication.ReadyToRun = [this] { ReadyToRunHandler(); };
+        // The trader is all there is to run
+        mAutoTrader.Stopped = [this] { mContext.stop(); };
     }
 
 private:
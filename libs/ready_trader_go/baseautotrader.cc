@@ -15,6 +15,8 @@
 //     You should have received a copy of the GNU Affero General Public
 //     License along with Ready Trader Go.  If not, see
 //     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+
 #include "baseautotrader.h"
 #include "error.h"
 #include "logging.h"
@@ -26,8 +28,11 @@ namespace ReadyTraderGo {
 
 void BaseAutoTrader::SetExecutionConnection(std::unique_ptr<IConnection>&& connection)
 {
+    mRetiredExecutionConnection = std::move(mExecutionConnection);
     mExecutionConnection = std::move(connection);
+    mExecutionState = ExecutionState::CONNECTED;
     mExecutionConnection->SetName("Exec");
+    mTimers.SetBusyPollMode(mExecutionConnection->IsBusyPollMode());
     mExecutionConnection->Disconnected = [this] { DisconnectHandler(); };
     mExecutionConnection->MessageReceived = [this](IConnection* c,
                                                    unsigned char t,
@@ -42,17 +47,79 @@ void BaseAutoTrader::SetExecutionConnection(std::unique_ptr<IConnection>&& conne
     mExecutionConnection->AsyncRead();
 }
 
+void BaseAutoTrader::DisconnectHandler()
+{
+    if (mExecutionConnectionFactory == nullptr || mExecutionState == ExecutionState::STOPPED)
+    {
+        Stop();
+        return;
+    }
+
+    RLOG(LG_BAT, LogLevel::LL_WARNING) << "execution connection lost, reconnecting";
+    mExecutionState = ExecutionState::RECONNECTING;
+    ScheduleReconnect();
+}
+
+void BaseAutoTrader::ScheduleReconnect()
+{
+    if (mReconnectAttempts >= RECONNECT_MAXIMUM_ATTEMPTS)
+    {
+        RLOG(LG_BAT, LogLevel::LL_ERROR) << "giving up after " << mReconnectAttempts << " reconnection attempts";
+        Stop();
+        return;
+    }
+
+    RLOG(LG_BAT, LogLevel::LL_INFO) << "reconnecting in " << mReconnectDelay.count() << "ms";
+    mReconnectTimer.expires_after(mReconnectDelay);
+    mReconnectTimer.async_wait([this](const boost::system::error_code& e) { ReconnectTimerHandler(e); });
+    mReconnectDelay = std::min(mReconnectDelay * 2, RECONNECT_MAXIMUM_DELAY);
+}
+
+void BaseAutoTrader::Stop()
+{
+    mExecutionState = ExecutionState::STOPPED;
+    if (Stopped)
+        Stopped();
+}
+
+void BaseAutoTrader::ReconnectTimerHandler(const boost::system::error_code& error)
+{
+    if (error)
+        return;
+
+    ++mReconnectAttempts;
+    try
+    {
+        SetExecutionConnection(mExecutionConnectionFactory->Create());
+    }
+    catch (const ReadyTraderGoError& e)
+    {
+        RLOG(LG_BAT, LogLevel::LL_WARNING) << "reconnection attempt " << mReconnectAttempts << " failed: "
+                                           << e.what();
+        ScheduleReconnect();
+        return;
+    }
+
+    RLOG(LG_BAT, LogLevel::LL_INFO) << "execution connection re-established after " << mReconnectAttempts
+                                    << " attempt(s)";
+    ReconnectedHandler();
+}
+
 void BaseAutoTrader::MessageHandler(IConnection* connection,
                                     unsigned char messageType,
                                     unsigned char const* data,
                                     std::size_t size)
 {
+    // Hearing from the exchange shows that the (re)connection is good.
+    mReconnectAttempts = 0;
+    mReconnectDelay = RECONNECT_INITIAL_DELAY;
+
     switch (messageType)
     {
     case MessageType::ERROR_MESSAGE:
     {
         auto err = makeMessage<ErrorMessage>(data, size);
-        ErrorMessageHandler(err.mClientOrderId, err.mMessage);
+        ErrorMessageHandler(err.mClientOrderId, err.mMessage.View());
         break;
     }
     case MessageType::HEDGE_FILLED:
@@ -92,16 +159,12 @@ void BaseAutoTrader::MessageHandler(ISubscription* subscription,
     {
     case MessageType::ORDER_BOOK_UPDATE:
     {
-        auto book = makeMessage<OrderBookMessage>(data, size);
-        OrderBookMessageHandler(book.mInstrument, book.mSequenceNumber, book.mAskPrices,
-                                book.mAskVolumes, book.mBidPrices, book.mBidVolumes);
+        DeliverOrderBook(makeMessage<OrderBookMessage>(data, size));
         break;
     }
     case MessageType::TRADE_TICKS:
     {
-        auto ticks = makeMessage<TradeTicksMessage>(data, size);
-        TradeTicksMessageHandler(ticks.mInstrument, ticks.mSequenceNumber, ticks.mAskPrices,
-                                 ticks.mAskVolumes, ticks.mBidPrices, ticks.mBidVolumes);
+        DeliverTradeTicks(makeMessage<TradeTicksMessage>(data, size));
         break;
     }
     default:
@@ -19,24 +19,46 @@
 #define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_BASEAUTOTRADER_H
 
 #include <array>
+#include <chrono>
 #include <cstddef>
+#include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/property_tree/ptree_fwd.hpp>
+#include <boost/system/error_code.hpp>
 
 #include "connectivitytypes.h"
 #include "protocol.h"
+#include "timerservice.h"
 #include "types.h"
 
 namespace ReadyTraderGo {
 
+// Delay before the first attempt to re-establish a lost execution connection,
+// doubling after each failure up to the maximum. After the given number of
+// consecutive failures the trader gives up and stops.
+constexpr std::chrono::milliseconds RECONNECT_INITIAL_DELAY{50};
+constexpr std::chrono::milliseconds RECONNECT_MAXIMUM_DELAY{2000};
+constexpr int RECONNECT_MAXIMUM_ATTEMPTS = 10;
+
+enum class ExecutionState : unsigned char
+{
+    DISCONNECTED,
+    CONNECTED,
+    RECONNECTING,
+    STOPPED
+};
+
 class BaseAutoTrader
 {
 public:
-    explicit BaseAutoTrader(boost::asio::io_context& context) : mContext(context) {};
+    explicit BaseAutoTrader(boost::asio::io_context& context) : mContext(context), mTimers(context), mReconnectTimer(context) {};
 
     virtual void SendAmendOrder(unsigned long clientOrderId, unsigned long volume);
     virtual void SendCancelOrder(unsigned long clientOrderId);
@@ -51,18 +73,51 @@ public:
                                  Lifespan lifespan);
 
     virtual void SetExecutionConnection(std::unique_ptr<IConnection>&& connection);
+    virtual void SetExecutionConnectionFactory(IConnectionFactory* factory);
     virtual void SetInformationSubscription(std::shared_ptr<ISubscription>&& subscription);
     virtual void SetLoginDetails(std::string teamName, std::string secret);
 
+    // Called with the trader's configuration when it is first loaded and
+    // each time it is reloaded, between the trader's other handlers.
+    virtual void LoadParameters(const boost::property_tree::ptree& tree) {};
+
+    // Deliver information messages that have already been decoded, e.g. by
+    // a StrategyHost sharing one information feed between several traders.
+    void DeliverOrderBook(const OrderBookMessage& book);
+    void DeliverTradeTicks(const TradeTicksMessage& ticks);
+
+    // The trader's timers, which a backtest drives in simulated time
+    TimerService& GetTimers() { return mTimers; }
+
+    ExecutionState GetExecutionState() const { return mExecutionState; }
+    bool IsExecutionConnected() const { return mExecutionState == ExecutionState::CONNECTED; }
+
+    // Called, on the trader's event loop, when the trader gives up on its
+    // execution connection. Whoever runs the trader decides what stopping
+    // means: the whole application for a lone trader, or just this trader
+    // in a StrategyHost.
+    std::function<void()> Stopped;
+
 protected:
     boost::asio::io_context& mContext;
     std::unique_ptr<IConnection> mExecutionConnection = nullptr;
     std::shared_ptr<ISubscription> mInformationSubscription = nullptr;
+    // Timers run from the event loop, polled along with the execution
+    // connection when it is in busy-poll mode
+    TimerService mTimers;
 
     std::string mTeamName;
     std::string mSecret;
 
+    // Called when the execution connection is lost. If a connection factory
+    // has been set, reconnection is attempted, otherwise the trader stops.
     virtual void DisconnectHandler();
+
+    // Called once a replacement execution connection has been established
+    // and the login message has been re-sent. The exchange's view of any
+    // orders sent before the disconnection arrives in subsequent order
+    // status messages.
+    virtual void ReconnectedHandler() {};
     virtual void MessageHandler(IConnection*, unsigned char, unsigned char const*, std::size_t);
     virtual void MessageHandler(ISubscription* subscription,
                                 unsigned char messageType,
@@ -70,6 +125,15 @@ protected:
                                 std::size_t size);
 
     // Message callbacks
+    //
+    // The error message view refers to the received message and is only
+    // valid for the duration of the call. By default it is passed on, as a
+    // std::string, to the older overload.
+    virtual void ErrorMessageHandler(unsigned long clientOrderId,
+                                     std::string_view errorMessage)
+    {
+        ErrorMessageHandler(clientOrderId, std::string(errorMessage));
+    };
     virtual void ErrorMessageHandler(unsigned long clientOrderId,
                                      const std::string& errorMessage) {};
     virtual void HedgeFilledMessageHandler(unsigned long clientOrderId,
@@ -94,11 +158,25 @@ protected:
                                           const std::array<unsigned long, TOP_LEVEL_COUNT>& askVolumes,
                                           const std::array<unsigned long, TOP_LEVEL_COUNT>& bidPrices,
                                           const std::array<unsigned long, TOP_LEVEL_COUNT>& bidVolumes) {};
+
+private:
+    void ReconnectTimerHandler(const boost::system::error_code& error);
+    void ScheduleReconnect();
+    void Stop();
+
+    ExecutionState mExecutionState = ExecutionState::DISCONNECTED;
+    IConnectionFactory* mExecutionConnectionFactory = nullptr;
+    // A replaced connection is kept until the following reconnection so
+    // that handlers still queued for it can run safely.
+    std::unique_ptr<IConnection> mRetiredExecutionConnection = nullptr;
+    boost::asio::steady_timer mReconnectTimer;
+    std::chrono::milliseconds mReconnectDelay = RECONNECT_INITIAL_DELAY;
+    int mReconnectAttempts = 0;
 };
 
-inline void BaseAutoTrader::DisconnectHandler()
+inline void BaseAutoTrader::SetExecutionConnectionFactory(IConnectionFactory* factory)
 {
-    mContext.stop();
+    mExecutionConnectionFactory = factory;
 }
 
 inline void BaseAutoTrader::SetInformationSubscription(std::shared_ptr<ISubscription>&& subscription)
@@ -112,6 +190,18 @@ inline void BaseAutoTrader::SetInformationSubscription(std::shared_ptr<ISubscrip
     mInformationSubscription->AsyncReceive();
 }
 
+inline void BaseAutoTrader::DeliverOrderBook(const OrderBookMessage& book)
+{
+    OrderBookMessageHandler(book.mInstrument, book.mSequenceNumber, book.mAskPrices,
+                            book.mAskVolumes, book.mBidPrices, book.mBidVolumes);
+}
+
+inline void BaseAutoTrader::DeliverTradeTicks(const TradeTicksMessage& ticks)
+{
+    TradeTicksMessageHandler(ticks.mInstrument, ticks.mSequenceNumber, ticks.mAskPrices,
+                             ticks.mAskVolumes, ticks.mBidPrices, ticks.mBidVolumes);
+}
+
 inline void BaseAutoTrader::SendAmendOrder(unsigned long clientOrderId, unsigned long volume)
 {
     mExecutionConnection->SendMessage(MessageType::AMEND_ORDER,
@@ -0,0 +1,183 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include "bookstate.h"
+
+#if defined(__x86_64__) && defined(__AVX2__)
+#define RTG_BOOK_DELTA_AVX2 1
+#include <immintrin.h>
+#elif defined(__x86_64__) && defined(__SSE2__)
+#define RTG_BOOK_DELTA_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace ReadyTraderGo {
+
+void ComputeBookSideDeltaScalar(const LevelArray& prices,
+                                const LevelArray& volumes,
+                                const LevelArray& previousPrices,
+                                const LevelArray& previousVolumes,
+                                BookSideDelta& delta) noexcept
+{
+    unsigned changed = 0;
+    unsigned long cumulative = 0;
+    unsigned long notional = 0;
+    for (std::size_t i = 0; i < TOP_LEVEL_COUNT; ++i)
+    {
+        changed |= unsigned((prices[i] != previousPrices[i]) | (volumes[i] != previousVolumes[i])) << i;
+        cumulative += volumes[i];
+        delta.mCumulativeVolumes[i] = cumulative;
+        notional += prices[i] * volumes[i];
+    }
+    delta.mChangedLevels = changed;
+    delta.mNotional = notional;
+}
+
+#if defined(RTG_BOOK_DELTA_AVX2)
+
+static_assert(TOP_LEVEL_COUNT == 5 && sizeof(unsigned long) == 8, "kernel assumes five 64-bit levels");
+
+// Levels 0-3 are handled in one 256-bit register and level 4 on its own.
+void ComputeBookSideDelta(const LevelArray& prices,
+                          const LevelArray& volumes,
+                          const LevelArray& previousPrices,
+                          const LevelArray& previousVolumes,
+                          BookSideDelta& delta) noexcept
+{
+    const __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prices.data()));
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(volumes.data()));
+    const __m256i pp = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(previousPrices.data()));
+    const __m256i pv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(previousVolumes.data()));
+
+    const __m256i same = _mm256_and_si256(_mm256_cmpeq_epi64(p, pp), _mm256_cmpeq_epi64(v, pv));
+    unsigned changed = ~unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(same))) & 0xFu;
+    changed |= unsigned((prices[4] != previousPrices[4]) | (volumes[4] != previousVolumes[4])) << 4;
+    delta.mChangedLevels = changed;
+
+    // Prefix sum: add the register shifted up by one lane, then by two.
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sum = _mm256_add_epi64(
+        v, _mm256_blend_epi32(_mm256_permute4x64_epi64(v, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+    sum = _mm256_add_epi64(
+        sum, _mm256_blend_epi32(_mm256_permute4x64_epi64(sum, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(delta.mCumulativeVolumes.data()), sum);
+    delta.mCumulativeVolumes[4] = delta.mCumulativeVolumes[3] + volumes[4];
+
+    // Prices and volumes fit in 32 bits so a 32x32->64 multiply is exact.
+    const __m256i products = _mm256_mul_epu32(p, v);
+    __m128i notional = _mm_add_epi64(_mm256_castsi256_si128(products), _mm256_extracti128_si256(products, 1));
+    notional = _mm_add_epi64(notional, _mm_unpackhi_epi64(notional, notional));
+    delta.mNotional = static_cast<unsigned long>(_mm_cvtsi128_si64(notional)) + prices[4] * volumes[4];
+}
+
+const char* BookDeltaKernelName() noexcept
+{
+    return "avx2";
+}
+
+#elif defined(RTG_BOOK_DELTA_SSE2)
+
+static_assert(TOP_LEVEL_COUNT == 5 && sizeof(unsigned long) == 8, "kernel assumes five 64-bit levels");
+
+// SSE2 has no 64-bit compare, so compare 32-bit halves and combine them.
+static inline __m128i cmpeq64(__m128i a, __m128i b) noexcept
+{
+    const __m128i eq = _mm_cmpeq_epi32(a, b);
+    return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+// Levels 0-1 and 2-3 are handled in two 128-bit registers and level 4 on
+// its own.
+void ComputeBookSideDelta(const LevelArray& prices,
+                          const LevelArray& volumes,
+                          const LevelArray& previousPrices,
+                          const LevelArray& previousVolumes,
+                          BookSideDelta& delta) noexcept
+{
+    const auto* p = reinterpret_cast<const __m128i*>(prices.data());
+    const auto* v = reinterpret_cast<const __m128i*>(volumes.data());
+    const auto* pp = reinterpret_cast<const __m128i*>(previousPrices.data());
+    const auto* pv = reinterpret_cast<const __m128i*>(previousVolumes.data());
+
+    const __m128i pLo = _mm_loadu_si128(p), pHi = _mm_loadu_si128(p + 1);
+    const __m128i vLo = _mm_loadu_si128(v), vHi = _mm_loadu_si128(v + 1);
+
+    const __m128i sameLo = _mm_and_si128(cmpeq64(pLo, _mm_loadu_si128(pp)), cmpeq64(vLo, _mm_loadu_si128(pv)));
+    const __m128i sameHi = _mm_and_si128(cmpeq64(pHi, _mm_loadu_si128(pp + 1)),
+                                         cmpeq64(vHi, _mm_loadu_si128(pv + 1)));
+    const unsigned same = unsigned(_mm_movemask_pd(_mm_castsi128_pd(sameLo)))
+                          | unsigned(_mm_movemask_pd(_mm_castsi128_pd(sameHi))) << 2;
+    unsigned changed = ~same & 0xFu;
+    changed |= unsigned((prices[4] != previousPrices[4]) | (volumes[4] != previousVolumes[4])) << 4;
+    delta.mChangedLevels = changed;
+
+    const __m128i sumLo = _mm_add_epi64(vLo, _mm_slli_si128(vLo, 8));
+    __m128i sumHi = _mm_add_epi64(vHi, _mm_slli_si128(vHi, 8));
+    sumHi = _mm_add_epi64(sumHi, _mm_unpackhi_epi64(sumLo, sumLo));
+    auto* cumulative = reinterpret_cast<__m128i*>(delta.mCumulativeVolumes.data());
+    _mm_storeu_si128(cumulative, sumLo);
+    _mm_storeu_si128(cumulative + 1, sumHi);
+    delta.mCumulativeVolumes[4] = delta.mCumulativeVolumes[3] + volumes[4];
+
+    // Prices and volumes fit in 32 bits so a 32x32->64 multiply is exact.
+    __m128i notional = _mm_add_epi64(_mm_mul_epu32(pLo, vLo), _mm_mul_epu32(pHi, vHi));
+    notional = _mm_add_epi64(notional, _mm_unpackhi_epi64(notional, notional));
+    delta.mNotional = static_cast<unsigned long>(_mm_cvtsi128_si64(notional)) + prices[4] * volumes[4];
+}
+
+const char* BookDeltaKernelName() noexcept
+{
+    return "sse2";
+}
+
+#else
+
+void ComputeBookSideDelta(const LevelArray& prices,
+                          const LevelArray& volumes,
+                          const LevelArray& previousPrices,
+                          const LevelArray& previousVolumes,
+                          BookSideDelta& delta) noexcept
+{
+    ComputeBookSideDeltaScalar(prices, volumes, previousPrices, previousVolumes, delta);
+}
+
+const char* BookDeltaKernelName() noexcept
+{
+    return "scalar";
+}
+
+#endif
+
+void ComputeBookSummary(unsigned long bestAsk, unsigned long bestBid, BookDelta& delta) noexcept
+{
+    const double askDepth = static_cast<double>(delta.mAsk.TotalVolume());
+    const double bidDepth = static_cast<double>(delta.mBid.TotalVolume());
+    const double depth = askDepth + bidDepth;
+
+    delta.mAskWeightedPrice = askDepth > 0.0 ? static_cast<double>(delta.mAsk.mNotional) / askDepth : 0.0;
+    delta.mBidWeightedPrice = bidDepth > 0.0 ? static_cast<double>(delta.mBid.mNotional) / bidDepth : 0.0;
+    delta.mImbalance = depth > 0.0 ? (bidDepth - askDepth) / depth : 0.0;
+
+    const double askTop = static_cast<double>(delta.mAsk.mCumulativeVolumes[0]);
+    const double bidTop = static_cast<double>(delta.mBid.mCumulativeVolumes[0]);
+    const bool twoSided = bestAsk != 0 && bestBid != 0 && askTop > 0.0 && bidTop > 0.0;
+    delta.mWeightedMid = twoSided ? (static_cast<double>(bestBid) * askTop + static_cast<double>(bestAsk) * bidTop)
+                                    / (askTop + bidTop)
+                                  : 0.0;
+}
+
+}
@@ -0,0 +1,142 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_BOOKSTATE_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_BOOKSTATE_H
+
+#include <array>
+#include <cstddef>
+
+#include "types.h"
+
+namespace ReadyTraderGo {
+
+using LevelArray = std::array<unsigned long, TOP_LEVEL_COUNT>;
+
+// What changed on one side of the book between two snapshots.
+struct BookSideDelta
+{
+    // Bit i is set if the price or volume at level i changed.
+    unsigned mChangedLevels = 0;
+    // Element i is the total volume at levels 0 to i.
+    LevelArray mCumulativeVolumes = {};
+    // Sum of price * volume over all levels.
+    unsigned long mNotional = 0;
+
+    unsigned long TotalVolume() const noexcept { return mCumulativeVolumes[TOP_LEVEL_COUNT - 1]; }
+};
+
+struct BookDelta
+{
+    BookSideDelta mAsk;
+    BookSideDelta mBid;
+
+    // Volume weighted average price of each side, or zero if it is empty.
+    double mAskWeightedPrice = 0.0;
+    double mBidWeightedPrice = 0.0;
+    // Best bid and ask weighted by the volume on the opposite side, or zero
+    // if either side is empty.
+    double mWeightedMid = 0.0;
+    // (bid depth - ask depth) / (bid depth + ask depth), in [-1, 1].
+    double mImbalance = 0.0;
+
+    bool Changed() const noexcept { return (mAsk.mChangedLevels | mBid.mChangedLevels) != 0; }
+    bool TopChanged() const noexcept { return ((mAsk.mChangedLevels | mBid.mChangedLevels) & 1u) != 0; }
+};
+
+// Compare one side of a snapshot with the previous one. Uses AVX2 or SSE2
+// when the compiler targets them and a scalar loop otherwise; all variants
+// produce identical results. Prices and volumes must fit in 32 bits, as
+// they do on the wire.
+void ComputeBookSideDelta(const LevelArray& prices,
+                          const LevelArray& volumes,
+                          const LevelArray& previousPrices,
+                          const LevelArray& previousVolumes,
+                          BookSideDelta& delta) noexcept;
+
+// The portable implementation of ComputeBookSideDelta.
+void ComputeBookSideDeltaScalar(const LevelArray& prices,
+                                const LevelArray& volumes,
+                                const LevelArray& previousPrices,
+                                const LevelArray& previousVolumes,
+                                BookSideDelta& delta) noexcept;
+
+// Fill in the derived prices and imbalance from the per side deltas.
+void ComputeBookSummary(unsigned long bestAsk, unsigned long bestBid, BookDelta& delta) noexcept;
+
+// Name of the instruction set ComputeBookSideDelta was built for.
+const char* BookDeltaKernelName() noexcept;
+
+// The last order book snapshot seen for one instrument, and how it differs
+// from the one before.
+class BookState
+{
+public:
+    // Record a new snapshot. Returns false, leaving the state unchanged, if
+    // the snapshot is older than the one already held.
+    bool Update(unsigned long sequenceNumber,
+                const LevelArray& askPrices,
+                const LevelArray& askVolumes,
+                const LevelArray& bidPrices,
+                const LevelArray& bidVolumes) noexcept;
+
+    const BookDelta& GetDelta() const noexcept { return mDelta; }
+    unsigned long GetSequenceNumber() const noexcept { return mSequenceNumber; }
+
+    const LevelArray& GetAskPrices() const noexcept { return mAskPrices; }
+    const LevelArray& GetAskVolumes() const noexcept { return mAskVolumes; }
+    const LevelArray& GetBidPrices() const noexcept { return mBidPrices; }
+    const LevelArray& GetBidVolumes() const noexcept { return mBidVolumes; }
+
+    unsigned long BestAsk() const noexcept { return mAskPrices[0]; }
+    unsigned long BestBid() const noexcept { return mBidPrices[0]; }
+
+private:
+    unsigned long mSequenceNumber = 0;
+    LevelArray mAskPrices = {};
+    LevelArray mAskVolumes = {};
+    LevelArray mBidPrices = {};
+    LevelArray mBidVolumes = {};
+    BookDelta mDelta;
+};
+
+inline bool BookState::Update(unsigned long sequenceNumber,
+                              const LevelArray& askPrices,
+                              const LevelArray& askVolumes,
+                              const LevelArray& bidPrices,
+                              const LevelArray& bidVolumes) noexcept
+{
+    if (sequenceNumber <= mSequenceNumber && mSequenceNumber != 0)
+    {
+        return false;
+    }
+
+    ComputeBookSideDelta(askPrices, askVolumes, mAskPrices, mAskVolumes, mDelta.mAsk);
+    ComputeBookSideDelta(bidPrices, bidVolumes, mBidPrices, mBidVolumes, mDelta.mBid);
+    ComputeBookSummary(askPrices[0], bidPrices[0], mDelta);
+
+    mSequenceNumber = sequenceNumber;
+    mAskPrices = askPrices;
+    mAskVolumes = askVolumes;
+    mBidPrices = bidPrices;
+    mBidVolumes = bidVolumes;
+    return true;
+}
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_BOOKSTATE_H
@@ -22,17 +22,33 @@
 
 #include <boost/property_tree/ptree.hpp>
 
+#include "connectivitytypes.h"
+
 namespace ReadyTraderGo {
 
 struct Config
 {
     void readFromPropertyTree(const boost::property_tree::ptree& tree)
     {
-        mExecHost = tree.get<std::string>("Execution.Host");
-        mExecPort = tree.get<unsigned short>("Execution.Port");
+        readTraderFromPropertyTree(tree);
 
         mInfoType = tree.get<std::string>("Information.Type");
         mInfoName = tree.get<std::string>("Information.Name");
+    }
+
+    // Read the settings that belong to one trader: its execution connection
+    // and login details.
+    void readTraderFromPropertyTree(const boost::property_tree::ptree& tree)
+    {
+        mExecHost = tree.get<std::string>("Execution.Host");
+        mExecPort = tree.get<unsigned short>("Execution.Port");
+
+        mExecSocketOptions.mBusyPollMode = tree.get<bool>("Execution.BusyPollMode", false);
+        mExecSocketOptions.mBusyPollMicroseconds = tree.get<int>("Execution.SocketOptions.BusyPoll", 0);
+        mExecSocketOptions.mReceiveBufferSize = tree.get<int>("Execution.SocketOptions.ReceiveBufferSize", 0);
+        mExecSocketOptions.mSendBufferSize = tree.get<int>("Execution.SocketOptions.SendBufferSize", 0);
+        mExecSocketOptions.mQuickAck = tree.get<bool>("Execution.SocketOptions.QuickAck", false);
+        mExecSocketOptions.mReceiveLowWatermark = tree.get<int>("Execution.SocketOptions.ReceiveLowWatermark", 0);
 
         mTeamName = tree.get<std::string>("TeamName");
         mSecret = tree.get<std::string>("Secret");
@@ -40,6 +56,7 @@ struct Config
 
     std::string mExecHost;
     unsigned short mExecPort;
+    SocketOptions mExecSocketOptions;
 
     std::string mInfoType;
     std::string mInfoName;
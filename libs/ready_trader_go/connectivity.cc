@@ -15,12 +15,15 @@
 //     You should have received a copy of the GNU Affero General Public
 //     License along with Ready Trader Go.  If not, see
 //     <https://www.gnu.org/licenses/>.
+#include <cerrno>
 #include <cstddef>
+#include <cstring>
 #include <iomanip>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include <boost/asio/buffer.hpp>
 #include <boost/asio/connect.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/error.hpp>
@@ -31,6 +34,10 @@
 #include <boost/interprocess/mapped_region.hpp>
 #include <boost/system/error_code.hpp>
 
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
 #include "connectivity.h"
 #include "error.h"
 #include "logging.h"
@@ -44,13 +51,17 @@ RTG_INLINE_GLOBAL_LOGGER_WITH_CHANNEL(LG_CON, "CON")
 
 namespace ReadyTraderGo {
 
-// Theoretical maximum size of an (IPv4) UDP packet (actual maximum is lower).
-constexpr std::size_t READ_SIZE = 65535;
-
 Connection::Connection(boost::asio::io_context& context, tcp::socket&& socket)
+    : Connection(context, std::move(socket), SocketOptions())
+{
+}
+
+Connection::Connection(boost::asio::io_context& context, tcp::socket&& socket, const SocketOptions& options)
     : mContext(context),
-      mInBuffer(),
-      mOutBuffer(),
+      mInBuffer(CONNECTION_IN_BUFFER_SIZE),
+      mOutBuffer(CONNECTION_OUT_BUFFER_SIZE),
+      mBusyPollMode(options.mBusyPollMode),
+      mQuickAck(options.mQuickAck),
       mSocket(std::move(socket))
 {
     SetName('\'' + std::to_string(mSocket.local_endpoint().port()) + '\'');
@@ -58,23 +69,68 @@ Connection::Connection(boost::asio::io_context& context, tcp::socket&& socket)
 
 Connection::~Connection()
 {
-    RLOG(LG_CON, LogLevel::LL_INFO) << std::quoted(mName, '\'') << " closing";
+    RLOG(LG_CON, LogLevel::LL_INFO) << std::quoted(mName, '\'') << " closing: in buffer high water mark="
+                                    << mInBuffer.GetStats().mHighWaterMark << " wraps="
+                                    << mInBuffer.GetStats().mWraps << ", out buffer high water mark="
+                                    << mOutBuffer.GetStats().mHighWaterMark << " wraps="
+                                    << mOutBuffer.GetStats().mWraps;
     if (mSocket.is_open())
     {
         mSocket.close();
     }
 }
 
+// Close the socket and report the disconnection once. Handlers for operations
+// that were outstanding on the socket still run, and find it closed.
+void Connection::Disconnect()
+{
+    if (mIsDisconnected)
+        return;
+
+    mIsDisconnected = true;
+    boost::system::error_code error;
+    mSocket.close(error);
+    OnDisconnect();
+}
+
 void Connection::AsyncRead()
 {
-    auto buf = mInBuffer.prepare(READ_SIZE);
+    if (mBusyPollMode)
+    {
+        boost::asio::post(mContext, makeAllocatingHandler(mReadHandlerMemory, [this] { PollRead(); }));
+        return;
+    }
+
+    // A partially received message is always shorter than the maximum message
+    // size, so there is always room for the rest of it.
+    auto* buf = mInBuffer.Prepare(MAXIMUM_MESSAGE_SIZE);
     mSocket.async_read_some(
-        buf,
-        [this](auto& error, auto size) { ReadSomeHandler(error, size); });
+        boost::asio::buffer(buf, mInBuffer.Writable()),
+        makeAllocatingHandler(mReadHandlerMemory,
+                              [this](auto& error, auto size) { ReadSomeHandler(error, size); }));
+}
+
+// In busy-poll mode the socket is read directly from the event loop, in turn
+// with the information subscription, rather than waiting for the reactor to
+// report that it is readable.
+void Connection::PollRead()
+{
+    boost::system::error_code error;
+    auto* buf = mInBuffer.Prepare(MAXIMUM_MESSAGE_SIZE);
+    const std::size_t size = mSocket.read_some(boost::asio::buffer(buf, mInBuffer.Writable()), error);
+    if (error == error::would_block || error == error::try_again)
+    {
+        boost::asio::post(mContext, makeAllocatingHandler(mReadHandlerMemory, [this] { PollRead(); }));
+        return;
+    }
+    ReadSomeHandler(error, size);
 }
 
 void Connection::ReadSomeHandler(const boost::system::error_code& error, std::size_t size)
 {
+    if (mIsDisconnected)
+        return;
+
     if (error)
     {
         if (error == error::eof)
@@ -93,17 +149,26 @@ void Connection::ReadSomeHandler(const boost::system::error_code& error, std::si
             RLOG(LG_CON, LogLevel::LL_ERROR) << std::quoted(mName, '\'') << " read error: "
                                              << error.message();
         }
-        OnDisconnect();
+        Disconnect();
         return;
     }
 
     RLOG(LG_CON, LogLevel::LL_DEBUG) << std::quoted(mName, '\'') << " received " << size
                                      << " bytes";
-    mInBuffer.commit(size);
+    mInBuffer.Commit(size);
 
-    auto* const begin = (unsigned char const*) mInBuffer.data().data();
+#ifdef TCP_QUICKACK
+    // Quick acknowledgement mode is not permanent, so it is re-armed after every read.
+    if (mQuickAck)
+    {
+        int one = 1;
+        ::setsockopt(mSocket.native_handle(), IPPROTO_TCP, TCP_QUICKACK, &one, sizeof(one));
+    }
+#endif
+
+    auto* const begin = mInBuffer.Data();
     auto* upto = begin;
-    auto available = size;
+    auto available = mInBuffer.Size();
 
     while (available >= MESSAGE_HEADER_SIZE)
     {
@@ -121,15 +186,16 @@ void Connection::ReadSomeHandler(const boost::system::error_code& error, std::si
         available -= messageLength;
     }
 
-    mInBuffer.consume(upto - begin);
+    mInBuffer.Consume(upto - begin);
     AsyncRead();
 }
 
 void Connection::Send()
 {
     mIsSending = true;
-    mSocket.async_write_some(mOutBuffer.data(),
-                             [this](auto& err, auto sz) { WriteSomeHandler(err, sz); });
+    mSocket.async_write_some(boost::asio::buffer(mOutBuffer.Data(), mOutBuffer.Size()),
+                             makeAllocatingHandler(mWriteHandlerMemory,
+                                                   [this](auto& err, auto sz) { WriteSomeHandler(err, sz); }));
 }
 
 void Connection::Send(SendMode mode)
@@ -140,26 +206,53 @@ void Connection::Send(SendMode mode)
     }
     else if (!mIsSendPosted)
     {
-        boost::asio::post(mContext, [this] {
+        boost::asio::post(mContext, makeAllocatingHandler(mPostHandlerMemory, [this] {
             mIsSendPosted = false;
-            if (!mIsSending)
+            if (!mIsSending && !mIsDisconnected)
             {
                 Send();
             }
-        });
+        }));
         mIsSendPosted = true;
     }
 }
 
 void Connection::SendMessage(unsigned char messageType, const ISerialisable& serialisable, SendMode mode)
 {
-    const std::size_t size = MESSAGE_HEADER_SIZE + serialisable.Size();
-    auto buf = mOutBuffer.prepare(size);
-    auto* data = static_cast<unsigned char*>(buf.data());
-    *(uint16_t*)data = boost::endian::native_to_big((uint16_t)size);
+    const std::size_t size = serialisable.Size();
+    if (auto* buf = PrepareMessage(messageType, size))
+    {
+        serialisable.Serialise(buf);
+        CommitMessage(size, mode);
+    }
+}
+
+unsigned char* Connection::PrepareMessage(unsigned char messageType, std::size_t size)
+{
+    if (mIsDisconnected)
+    {
+        RLOG(LG_CON, LogLevel::LL_WARNING) << std::quoted(mName, '\'') << " dropped message with type="
+                                           << static_cast<int>(messageType) << " while disconnected";
+        return nullptr;
+    }
+
+    const std::size_t frameSize = MESSAGE_HEADER_SIZE + size;
+    // Bytes being written by an outstanding send must not be moved.
+    auto* data = mOutBuffer.Prepare(frameSize, !mIsSending);
+    if (data == nullptr)
+    {
+        RLOG(LG_CON, LogLevel::LL_ERROR) << std::quoted(mName, '\'') << " send buffer full";
+        Disconnect();
+        return nullptr;
+    }
+    *(uint16_t*)data = boost::endian::native_to_big((uint16_t)frameSize);
     data[MESSAGE_TYPE_OFFSET] = messageType;
-    serialisable.Serialise(data + MESSAGE_HEADER_SIZE);
-    mOutBuffer.commit(size);
+    return data + MESSAGE_HEADER_SIZE;
+}
+
+void Connection::CommitMessage(std::size_t size, SendMode mode)
+{
+    mOutBuffer.Commit(MESSAGE_HEADER_SIZE + size);
     if (!mIsSending)
     {
         Send(mode);
@@ -168,13 +261,21 @@ void Connection::SendMessage(unsigned char messageType, const ISerialisable& ser
 
 void Connection::WriteSomeHandler(const boost::system::error_code& error, std::size_t size)
 {
+    if (mIsDisconnected)
+    {
+        mIsSending = false;
+        return;
+    }
+
     if (error)
     {
         if (error != error::interrupted && error != error::would_block && error != error::try_again)
         {
             RLOG(LG_CON, LogLevel::LL_ERROR) << std::quoted(mName, '\'') << " send failed: "
                                              << error.message();
-            throw ReadyTraderGoError("send failed: " + error.message());
+            mIsSending = false;
+            Disconnect();
+            return;
         }
         RLOG(LG_CON, LogLevel::LL_DEBUG) << std::quoted(mName, '\'') << " send interrupted: "
                                          << error.message();
@@ -183,13 +284,19 @@ void Connection::WriteSomeHandler(const boost::system::error_code& error, std::s
     {
         RLOG(LG_CON, LogLevel::LL_DEBUG) << std::quoted(mName, '\'') << " sent "
                                          << size << " bytes";
-        mOutBuffer.consume(size);
+        mOutBuffer.Consume(size);
     }
 
-    if (mOutBuffer.size() > 0)
+    if (mOutBuffer.Size() > 0)
     {
+        // Nothing refers to the unsent bytes until the next write is issued,
+        // so move them up to keep the whole buffer available under
+        // sustained sending.
+        mOutBuffer.Compact();
         mSocket.async_write_some(
-            mOutBuffer.data(), [this](auto& err, auto sz) { WriteSomeHandler(err, sz); });
+            boost::asio::buffer(mOutBuffer.Data(), mOutBuffer.Size()),
+            makeAllocatingHandler(mWriteHandlerMemory,
+                                  [this](auto& err, auto sz) { WriteSomeHandler(err, sz); }));
     }
     else
     {
@@ -211,7 +318,8 @@ Subscription::~Subscription()
 void Subscription::AsyncReceive()
 {
     std::weak_ptr<ISubscription> weak_this = shared_from_this();
-    mContext.post([this, weak_this](){ AsyncReceive(0, weak_this); });
+    boost::asio::post(mContext, makeAllocatingHandler(mHandlerMemory,
+                                                      [this, weak_this](){ AsyncReceive(0, weak_this); }));
 }
 
 void Subscription::AsyncReceive(unsigned long pos, std::weak_ptr<ISubscription> weak_this)
@@ -232,7 +340,8 @@ void Subscription::AsyncReceive(unsigned long pos, std::weak_ptr<ISubscription>
         pos = (pos + FRAME_SIZE) & (SUBSCRIPTION_TRANSPORT_BUFFER_SIZE - 1);
     }
 
-    mContext.post([this, pos, weak_this](){ AsyncReceive(pos, weak_this); });
+    boost::asio::post(mContext, makeAllocatingHandler(mHandlerMemory,
+                                                      [this, pos, weak_this](){ AsyncReceive(pos, weak_this); }));
 }
 
 void Subscription::ReceiveFromHandler(unsigned char const* data, std::size_t size)
@@ -259,8 +368,9 @@ void Subscription::ReceiveFromHandler(unsigned char const* data, std::size_t siz
 
 ConnectionFactory::ConnectionFactory(boost::asio::io_context& context,
                                      std::string host,
-                                     unsigned short port)
-    : mContext(context), mHost(std::move(host)), mPort(port)
+                                     unsigned short port,
+                                     const SocketOptions& options)
+    : mContext(context), mHost(std::move(host)), mPort(port), mSocketOptions(options)
 {
     boost::system::error_code error;
     tcp::resolver resolver(mContext);
@@ -284,6 +394,72 @@ static std::basic_ostream<C, T>& operator<<(std::basic_ostream<C, T>& strm, cons
     return strm;
 }
 
+// Set an integer socket option and read it back to find out whether the
+// kernel accepted it (buffer sizes, for example, may be doubled or capped).
+static SocketOptionResult applySocketOption(tcp::socket& sock, const char* name, int level, int option, int value)
+{
+    SocketOptionResult result{name, value, 0, false};
+    if (::setsockopt(sock.native_handle(), level, option, &value, sizeof(value)) != 0)
+    {
+        RLOG(LG_CON, LogLevel::LL_WARNING) << "failed to set " << name << '=' << value << ": "
+                                           << std::strerror(errno);
+        return result;
+    }
+
+    socklen_t length = sizeof(result.mEffective);
+    ::getsockopt(sock.native_handle(), level, option, &result.mEffective, &length);
+    result.mApplied = result.mEffective >= value;
+    RLOG(LG_CON, LogLevel::LL_INFO) << name << '=' << value << (result.mApplied ? " applied" : " not applied")
+                                    << " (effective value " << result.mEffective << ')';
+    return result;
+}
+
+static std::vector<SocketOptionResult> applySocketOptions(tcp::socket& sock, const SocketOptions& options)
+{
+    std::vector<SocketOptionResult> results;
+
+    if (options.mBusyPollMicroseconds > 0)
+    {
+#ifdef SO_BUSY_POLL
+        results.push_back(applySocketOption(sock, "SO_BUSY_POLL", SOL_SOCKET, SO_BUSY_POLL,
+                                            options.mBusyPollMicroseconds));
+#else
+        RLOG(LG_CON, LogLevel::LL_WARNING) << "SO_BUSY_POLL is not supported on this platform";
+        results.push_back({"SO_BUSY_POLL", options.mBusyPollMicroseconds, 0, false});
+#endif
+    }
+
+    if (options.mReceiveBufferSize > 0)
+    {
+        results.push_back(applySocketOption(sock, "SO_RCVBUF", SOL_SOCKET, SO_RCVBUF,
+                                            options.mReceiveBufferSize));
+    }
+
+    if (options.mSendBufferSize > 0)
+    {
+        results.push_back(applySocketOption(sock, "SO_SNDBUF", SOL_SOCKET, SO_SNDBUF,
+                                            options.mSendBufferSize));
+    }
+
+    if (options.mQuickAck)
+    {
+#ifdef TCP_QUICKACK
+        results.push_back(applySocketOption(sock, "TCP_QUICKACK", IPPROTO_TCP, TCP_QUICKACK, 1));
+#else
+        RLOG(LG_CON, LogLevel::LL_WARNING) << "TCP_QUICKACK is not supported on this platform";
+        results.push_back({"TCP_QUICKACK", 1, 0, false});
+#endif
+    }
+
+    if (options.mReceiveLowWatermark > 0)
+    {
+        results.push_back(applySocketOption(sock, "SO_RCVLOWAT", SOL_SOCKET, SO_RCVLOWAT,
+                                            options.mReceiveLowWatermark));
+    }
+
+    return results;
+}
+
 std::unique_ptr<IConnection> ConnectionFactory::Create()
 {
     boost::system::error_code error;
@@ -305,7 +481,14 @@ std::unique_ptr<IConnection> ConnectionFactory::Create()
     // It's not the end of the world if this fails, so any error is ignored.
     sock.set_option(tcp::no_delay(true), error);
 
-    return std::make_unique<Connection>(mContext, std::move(sock));
+    mSocketOptionResults = applySocketOptions(sock, mSocketOptions);
+
+    if (mSocketOptions.mBusyPollMode)
+    {
+        RLOG(LG_CON, LogLevel::LL_INFO) << "using busy-poll mode for connection to: " << sock.remote_endpoint();
+    }
+
+    return std::make_unique<Connection>(mContext, std::move(sock), mSocketOptions);
 }
 
 SubscriptionFactory::SubscriptionFactory(boost::asio::io_context& context,
@@ -25,12 +25,13 @@
 
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
-#include <boost/asio/streambuf.hpp>
 #include <boost/interprocess/file_mapping.hpp>
 #include <boost/interprocess/mapped_region.hpp>
 #include <boost/system/error_code.hpp>
 
 #include "connectivitytypes.h"
+#include "handlerallocator.h"
+#include "ringbuffer.h"
 
 namespace interprocess = boost::interprocess;
 using boost::asio::ip::tcp;
@@ -51,16 +52,33 @@ constexpr std::size_t FRAME_HEADER_SIZE = 8;
 constexpr std::size_t FRAME_SIZE = 128;
 constexpr std::size_t SUBSCRIPTION_TRANSPORT_BUFFER_SIZE = 8182;
 
+// Capacities of the connection buffers. The inbound buffer is large enough
+// to hold a partially received message of the maximum length and still have
+// room for another.
+constexpr std::size_t MAXIMUM_MESSAGE_SIZE = 65535;
+constexpr std::size_t CONNECTION_IN_BUFFER_SIZE = 2 * (MAXIMUM_MESSAGE_SIZE + 1);
+constexpr std::size_t CONNECTION_OUT_BUFFER_SIZE = 65536;
+
 
 class Connection : public IConnection
 {
 public:
     Connection(boost::asio::io_context& context, tcp::socket&& socket);
+    Connection(boost::asio::io_context& context, tcp::socket&& socket, const SocketOptions& options);
     ~Connection() override;
     void AsyncRead() override;
+    using IConnection::SendMessage;
     void SendMessage(unsigned char messageType, const ISerialisable& serialisable, SendMode mode) override;
+    unsigned char* PrepareMessage(unsigned char messageType, std::size_t size) override;
+    void CommitMessage(std::size_t size, SendMode mode) override;
+    bool IsBusyPollMode() const override { return mBusyPollMode; }
+
+    const RingBufferStats& GetInBufferStats() const { return mInBuffer.GetStats(); }
+    const RingBufferStats& GetOutBufferStats() const { return mOutBuffer.GetStats(); }
 
 private:
+    void Disconnect();
+    void PollRead();
     void Send();
     void Send(SendMode mode);
 
@@ -68,10 +86,16 @@ private:
     void WriteSomeHandler(const boost::system::error_code& error, std::size_t size);
 
     boost::asio::io_context& mContext;
-    boost::asio::streambuf mInBuffer;
-    boost::asio::streambuf mOutBuffer;
+    RingBuffer mInBuffer;
+    RingBuffer mOutBuffer;
+    HandlerMemory mReadHandlerMemory;
+    HandlerMemory mWriteHandlerMemory;
+    HandlerMemory mPostHandlerMemory;
+    bool mIsDisconnected = false;
     bool mIsSending = false;
     bool mIsSendPosted = false;
+    bool mBusyPollMode = false;
+    bool mQuickAck = false;
     tcp::socket mSocket;
 };
 
@@ -91,6 +115,7 @@ private:
     boost::asio::io_context& mContext;
     interprocess::file_mapping mFile;
     interprocess::mapped_region mRegion;
+    HandlerMemory mHandlerMemory;
 };
 
 class ConnectionFactory : public IConnectionFactory
@@ -98,15 +123,21 @@ class ConnectionFactory : public IConnectionFactory
 public:
     ConnectionFactory(boost::asio::io_context& context,
                       std::string host,
-                      unsigned short port);
+                      unsigned short port,
+                      const SocketOptions& options = SocketOptions());
 
     std::unique_ptr<IConnection> Create() override;
 
+    // Outcome of applying the socket options to the most recent connection.
+    const std::vector<SocketOptionResult>& GetSocketOptionResults() const { return mSocketOptionResults; }
+
 private:
     boost::asio::io_context& mContext;
     std::vector<tcp::endpoint> mEndpoints;
     std::string mHost;
     unsigned short mPort;
+    SocketOptions mSocketOptions;
+    std::vector<SocketOptionResult> mSocketOptionResults;
 };
 
 class SubscriptionFactory : public ISubscriptionFactory
@@ -31,6 +31,26 @@ enum class SendMode
     SOON
 };
 
+// Optional kernel socket tuning for a connection. A value of zero (or false)
+// leaves the corresponding option at the operating system default.
+struct SocketOptions
+{
+    bool mBusyPollMode = false;
+    int mBusyPollMicroseconds = 0;
+    int mReceiveBufferSize = 0;
+    int mSendBufferSize = 0;
+    bool mQuickAck = false;
+    int mReceiveLowWatermark = 0;
+};
+
+struct SocketOptionResult
+{
+    const char* mName;
+    int mRequested;
+    int mEffective;
+    bool mApplied;
+};
+
 struct ISerialisable
 {
     virtual std::size_t Size() const noexcept = 0;
@@ -50,6 +70,28 @@ struct IConnection
         SendMessage(messageType, serialisable, SendMode::ASAP);
     }
 
+    // Send a message whose wire layout is known at compile time. The message
+    // is encoded straight into the send buffer by Message::Schema.
+    template<typename Message, typename Schema = typename Message::Schema>
+    void SendMessage(unsigned char messageType, const Message& message, SendMode mode = SendMode::ASAP)
+    {
+        if (auto* buf = PrepareMessage(messageType, Schema::SIZE))
+        {
+            Schema::Serialise(message, buf);
+            CommitMessage(Schema::SIZE, mode);
+        }
+    }
+
+    // Reserve space for a message with a payload of the given size and write
+    // its header. Returns where the payload should be written, or nullptr if
+    // the message is to be dropped. Must be followed by CommitMessage.
+    virtual unsigned char* PrepareMessage(unsigned char messageType, std::size_t size) = 0;
+    virtual void CommitMessage(std::size_t size, SendMode mode) = 0;
+
+    // True if the connection is read by polling from the event loop, which
+    // then never waits (see SocketOptions::mBusyPollMode).
+    virtual bool IsBusyPollMode() const { return false; }
+
     const std::string& GetName() const { return mName; }
     void SetName(std::string name) { mName = std::move(name); }
 
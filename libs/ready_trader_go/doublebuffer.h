@@ -0,0 +1,61 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_DOUBLEBUFFER_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_DOUBLEBUFFER_H
+
+#include <array>
+
+namespace ReadyTraderGo {
+
+// Two copies of a value: the active one, which readers use, and a staging
+// one, which is filled in and then made active in a single step. Reading is
+// one pointer load, so the value can be used on the hot path much like a
+// constant, while replacing it never exposes a half-written value.
+//
+// Not thread safe: Staging and Publish must be called on the same thread
+// as the readers, between the handlers that use the value.
+template<typename T>
+class DoubleBuffer
+{
+public:
+    explicit DoubleBuffer(const T& initial = T()) : mSlots{initial, initial} {}
+
+    DoubleBuffer(const DoubleBuffer&) = delete;
+    void operator=(const DoubleBuffer&) = delete;
+
+    const T& Get() const noexcept { return *mActive; }
+
+    // The inactive copy, initially equal to the active one.
+    T& Staging() noexcept
+    {
+        T& staging = mSlots[mActive == &mSlots[0] ? 1 : 0];
+        staging = *mActive;
+        return staging;
+    }
+
+    // Make the staging copy active.
+    void Publish() noexcept { mActive = &mSlots[mActive == &mSlots[0] ? 1 : 0]; }
+
+private:
+    std::array<T, 2> mSlots;
+    const T* mActive = &mSlots[0];
+};
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_DOUBLEBUFFER_H
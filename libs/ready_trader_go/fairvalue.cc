@@ -0,0 +1,105 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include "fairvalue.h"
+
+#include <cmath>
+
+namespace ReadyTraderGo {
+
+FairValue::FairValue(double etfClamp, unsigned long tickSize) noexcept
+    : mEtfClamp(etfClamp), mTickSize(tickSize)
+{
+}
+
+void FairValue::Configure(double etfClamp, unsigned long tickSize) noexcept
+{
+    mEtfClamp = etfClamp;
+    mTickSize = tickSize;
+    mTheoreticalPrice = 0;
+    Publish();
+}
+
+bool FairValue::OnOrderBook(Instrument instrument, const BookState& book) noexcept
+{
+    if (instrument == Instrument::ETF)
+    {
+        mEtfMid = book.GetDelta().mWeightedMid;
+        return false;
+    }
+
+    mFutureMid = book.GetDelta().mWeightedMid;
+    return Publish();
+}
+
+bool FairValue::OnTradeTicks(Instrument instrument,
+                             const LevelArray& askPrices,
+                             const LevelArray& askVolumes,
+                             const LevelArray& bidPrices,
+                             const LevelArray& bidVolumes) noexcept
+{
+    // The ticks do not say which trade was last, so take the average price
+    unsigned long volume = 0;
+    unsigned long notional = 0;
+    for (std::size_t i = 0; i < TOP_LEVEL_COUNT; ++i)
+    {
+        volume += askVolumes[i] + bidVolumes[i];
+        notional += askPrices[i] * askVolumes[i] + bidPrices[i] * bidVolumes[i];
+    }
+    if (volume == 0)
+    {
+        return false;
+    }
+    const unsigned long price = (notional + volume / 2) / volume;
+
+    if (instrument == Instrument::ETF)
+    {
+        mEtfLastTradedPrice = price;
+        return false;
+    }
+
+    mFutureLastTradedPrice = price;
+    return mFutureMid == 0.0 && Publish();
+}
+
+bool FairValue::Publish() noexcept
+{
+    mRawTheoreticalPrice = (mFutureMid != 0.0) ? mFutureMid : static_cast<double>(mFutureLastTradedPrice);
+    if (mRawTheoreticalPrice == 0.0)
+    {
+        return false;
+    }
+
+    const auto tickSize = static_cast<double>(mTickSize);
+    const auto theoreticalPrice = static_cast<unsigned long>(std::nearbyint(mRawTheoreticalPrice / tickSize) * tickSize);
+
+    // As the exchange does: round(clamp * future price), less any part tick
+    const auto futurePrice = static_cast<unsigned long>(std::nearbyint(mRawTheoreticalPrice));
+    auto delta = static_cast<unsigned long>(std::nearbyint(mEtfClamp * static_cast<double>(futurePrice)));
+    delta -= delta % mTickSize;
+    mLowerBound = futurePrice - delta;
+    mUpperBound = futurePrice + delta;
+
+    if (theoreticalPrice == mTheoreticalPrice)
+    {
+        return false;
+    }
+    mTheoreticalPrice = theoreticalPrice;
+    return true;
+}
+
+}
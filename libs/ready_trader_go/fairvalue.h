@@ -0,0 +1,108 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_FAIRVALUE_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_FAIRVALUE_H
+
+#include "bookstate.h"
+#include "types.h"
+
+namespace ReadyTraderGo {
+
+// The fair value of the ETF, maintained from both instruments' order books
+// and trade ticks.
+//
+// The ETF tracks the future, so its theoretical price is the future's
+// weighted mid-price, or the future's last traded price while either side of
+// its book is empty. The exchange values ETF positions at the ETF price
+// clamped to within 'etfClamp' of the future price (rounded down to a whole
+// tick) and those bounds are kept alongside.
+//
+// The theoretical price is published rounded to the nearest tick. The update
+// methods return true when the published price changes - that is, when the
+// fair value has moved by at least one tick - so callers can re-quote only
+// then.
+class FairValue
+{
+public:
+    explicit FairValue(double etfClamp = 0.002, unsigned long tickSize = 100) noexcept;
+
+    // Change the clamp or tick size; the bounds are recalculated straight away.
+    void Configure(double etfClamp, unsigned long tickSize) noexcept;
+
+    bool OnOrderBook(Instrument instrument, const BookState& book) noexcept;
+    bool OnTradeTicks(Instrument instrument,
+                      const LevelArray& askPrices,
+                      const LevelArray& askVolumes,
+                      const LevelArray& bidPrices,
+                      const LevelArray& bidVolumes) noexcept;
+
+    // False until the future has been seen to trade or to have a two-sided book.
+    bool IsValid() const noexcept { return mTheoreticalPrice != 0; }
+
+    unsigned long GetTheoreticalPrice() const noexcept { return mTheoreticalPrice; }
+    double GetRawTheoreticalPrice() const noexcept { return mRawTheoreticalPrice; }
+    unsigned long GetLowerBound() const noexcept { return mLowerBound; }
+    unsigned long GetUpperBound() const noexcept { return mUpperBound; }
+
+    // The bounds rounded inwards to whole ticks: the most it is worth paying
+    // for the ETF and the least it is worth selling it for.
+    unsigned long GetMaxBidPrice() const noexcept { return mUpperBound / mTickSize * mTickSize; }
+    unsigned long GetMinAskPrice() const noexcept { return (mLowerBound + mTickSize - 1) / mTickSize * mTickSize; }
+
+    // ETF weighted mid-price less the raw theoretical price, or zero if
+    // either is unknown.
+    double GetEtfPremium() const noexcept;
+    unsigned long GetEtfLastTradedPrice() const noexcept { return mEtfLastTradedPrice; }
+
+    // Limit an ETF price to the clamp bounds.
+    unsigned long Clamp(unsigned long etfPrice) const noexcept;
+
+private:
+    bool Publish() noexcept;
+
+    double mEtfClamp;
+    unsigned long mTickSize;
+
+    double mFutureMid = 0.0;
+    unsigned long mFutureLastTradedPrice = 0;
+    double mEtfMid = 0.0;
+    unsigned long mEtfLastTradedPrice = 0;
+
+    double mRawTheoreticalPrice = 0.0;
+    unsigned long mTheoreticalPrice = 0;
+    unsigned long mLowerBound = 0;
+    unsigned long mUpperBound = 0;
+};
+
+inline double FairValue::GetEtfPremium() const noexcept
+{
+    return (mEtfMid != 0.0 && mRawTheoreticalPrice != 0.0) ? mEtfMid - mRawTheoreticalPrice : 0.0;
+}
+
+inline unsigned long FairValue::Clamp(unsigned long etfPrice) const noexcept
+{
+    if (!IsValid())
+    {
+        return etfPrice;
+    }
+    return (etfPrice < mLowerBound) ? mLowerBound : (etfPrice > mUpperBound) ? mUpperBound : etfPrice;
+}
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_FAIRVALUE_H
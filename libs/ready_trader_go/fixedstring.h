@@ -0,0 +1,89 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_FIXEDSTRING_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_FIXEDSTRING_H
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace ReadyTraderGo {
+
+// A string of at most N characters stored inline, in the same zero-padded
+// form used on the wire, so reading or writing one never allocates.
+template<std::size_t N>
+class FixedString
+{
+public:
+    FixedString() = default;
+    FixedString(std::string_view str) { Assign(str); }
+
+    FixedString& operator=(std::string_view str)
+    {
+        Assign(str);
+        return *this;
+    }
+
+    // Strings longer than N characters are truncated.
+    void Assign(std::string_view str) noexcept
+    {
+        mSize = (str.size() < N) ? str.size() : N;
+        std::memcpy(mData.data(), str.data(), mSize);
+        std::memset(mData.data() + mSize, 0, N - mSize);
+    }
+
+    // Read N bytes of zero-padded characters.
+    void Read(unsigned char const* data) noexcept
+    {
+        std::memcpy(mData.data(), data, N);
+        auto* end = static_cast<char const*>(std::memchr(mData.data(), 0, N));
+        mSize = (end != nullptr) ? end - mData.data() : N;
+    }
+
+    // Write N bytes of zero-padded characters.
+    void Write(unsigned char* buf) const noexcept { std::memcpy(buf, mData.data(), N); }
+
+    std::string_view View() const noexcept { return {mData.data(), mSize}; }
+    operator std::string_view() const noexcept { return View(); }
+    std::string ToString() const { return std::string(View()); }
+
+    bool Empty() const noexcept { return mSize == 0; }
+    std::size_t Size() const noexcept { return mSize; }
+    static constexpr std::size_t Capacity() noexcept { return N; }
+
+    bool operator==(std::string_view other) const noexcept { return View() == other; }
+    bool operator!=(std::string_view other) const noexcept { return View() != other; }
+
+private:
+    std::array<char, N> mData = {};
+    std::size_t mSize = 0;
+};
+
+template<typename C, typename T, std::size_t N>
+std::basic_ostream<C, T>& operator<<(std::basic_ostream<C, T>& strm, const FixedString<N>& str)
+{
+    strm << str.View();
+    return strm;
+}
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_FIXEDSTRING_H
@@ -0,0 +1,134 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_HANDLERALLOCATOR_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_HANDLERALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ReadyTraderGo {
+
+// Enough for any of the completion handlers used by the connectivity classes.
+constexpr std::size_t HANDLER_MEMORY_SIZE = 256;
+
+// Storage for the handler of one outstanding asynchronous operation.
+//
+// Asio releases a handler's memory before invoking it, so an operation that
+// starts its successor from inside its own handler reuses the same block. If
+// the block is already in use, or too small, memory comes from the heap and
+// the fallback is counted.
+class HandlerMemory
+{
+public:
+    HandlerMemory() = default;
+
+    HandlerMemory(const HandlerMemory&) = delete;
+    void operator=(const HandlerMemory&) = delete;
+
+    void* Allocate(std::size_t size)
+    {
+        if (!mInUse && size <= sizeof(mStorage))
+        {
+            mInUse = true;
+            return &mStorage;
+        }
+        ++mFallbackCount;
+        return ::operator new(size);
+    }
+
+    void Deallocate(void* pointer)
+    {
+        if (pointer == &mStorage)
+        {
+            mInUse = false;
+        }
+        else
+        {
+            ::operator delete(pointer);
+        }
+    }
+
+    std::size_t GetFallbackCount() const noexcept { return mFallbackCount; }
+
+private:
+    typename std::aligned_storage<HANDLER_MEMORY_SIZE>::type mStorage;
+    bool mInUse = false;
+    std::size_t mFallbackCount = 0;
+};
+
+// Minimal allocator, suitable for Asio's associated_allocator, that draws on
+// a HandlerMemory block.
+template<typename T>
+class HandlerAllocator
+{
+public:
+    using value_type = T;
+
+    explicit HandlerAllocator(HandlerMemory& memory) noexcept : mMemory(memory) {}
+
+    template<typename U>
+    HandlerAllocator(const HandlerAllocator<U>& other) noexcept : mMemory(other.mMemory) {}
+
+    bool operator==(const HandlerAllocator& other) const noexcept { return &mMemory == &other.mMemory; }
+    bool operator!=(const HandlerAllocator& other) const noexcept { return &mMemory != &other.mMemory; }
+
+    T* allocate(std::size_t n) const { return static_cast<T*>(mMemory.Allocate(sizeof(T) * n)); }
+    void deallocate(T* pointer, std::size_t) const { mMemory.Deallocate(pointer); }
+
+private:
+    template<typename> friend class HandlerAllocator;
+
+    HandlerMemory& mMemory;
+};
+
+// Wraps a completion handler so that Asio allocates its operation state from
+// the given HandlerMemory.
+template<typename Handler>
+class AllocatingHandler
+{
+public:
+    using allocator_type = HandlerAllocator<Handler>;
+
+    AllocatingHandler(HandlerMemory& memory, Handler handler)
+        : mMemory(memory), mHandler(std::move(handler)) {}
+
+    allocator_type get_allocator() const noexcept { return allocator_type(mMemory); }
+
+    template<typename... Args>
+    void operator()(Args&&... args)
+    {
+        mHandler(std::forward<Args>(args)...);
+    }
+
+private:
+    HandlerMemory& mMemory;
+    Handler mHandler;
+};
+
+template<typename Handler>
+inline AllocatingHandler<typename std::decay<Handler>::type> makeAllocatingHandler(HandlerMemory& memory,
+                                                                                   Handler&& handler)
+{
+    return AllocatingHandler<typename std::decay<Handler>::type>(memory, std::forward<Handler>(handler));
+}
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_HANDLERALLOCATOR_H
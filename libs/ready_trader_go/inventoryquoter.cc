@@ -0,0 +1,92 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <cmath>
+
+#include "inventoryquoter.h"
+
+namespace ReadyTraderGo {
+
+void InventoryQuoter::Configure(const InventoryQuoterConfig& config) noexcept
+{
+    mConfig = config;
+    mVolatilityDecay = mConfig.mVolatilityHalfLife > 0.0 ? std::exp2(-1.0 / mConfig.mVolatilityHalfLife) : 0.0;
+    mIntensityDecay = mConfig.mIntensityHalfLife > 0.0 ? std::exp2(-1.0 / mConfig.mIntensityHalfLife) : 0.0;
+    UpdateCoefficients();
+}
+
+void InventoryQuoter::OnTick(double mid) noexcept
+{
+    if (mid <= 0.0)
+        return;
+
+    if (mLastMid != 0.0)
+    {
+        const double change = mid - mLastMid;
+        mVariance = mHaveVolatility ? mVolatilityDecay * mVariance + (1.0 - mVolatilityDecay) * change * change
+                                    : change * change;
+        mHaveVolatility = true;
+        UpdateCoefficients();
+    }
+    mLastMid = mid;
+}
+
+void InventoryQuoter::OnTradeTicks(double mid,
+                                   const LevelArray& askPrices,
+                                   const LevelArray& askVolumes,
+                                   const LevelArray& bidPrices,
+                                   const LevelArray& bidVolumes) noexcept
+{
+    if (mid <= 0.0)
+        return;
+
+    double distance = 0.0;
+    double volume = 0.0;
+    for (std::size_t i = 0; i < TOP_LEVEL_COUNT; ++i)
+    {
+        if (askVolumes[i] != 0)
+        {
+            distance += std::fabs(static_cast<double>(askPrices[i]) - mid) * static_cast<double>(askVolumes[i]);
+            volume += static_cast<double>(askVolumes[i]);
+        }
+        if (bidVolumes[i] != 0)
+        {
+            distance += std::fabs(static_cast<double>(bidPrices[i]) - mid) * static_cast<double>(bidVolumes[i]);
+            volume += static_cast<double>(bidVolumes[i]);
+        }
+    }
+    if (volume == 0.0)
+        return;
+
+    distance /= volume;
+    mMeanTradeDistance = mHaveIntensity ? mIntensityDecay * mMeanTradeDistance + (1.0 - mIntensityDecay) * distance
+                                        : distance;
+    mHaveIntensity = true;
+    UpdateCoefficients();
+}
+
+void InventoryQuoter::UpdateCoefficients() noexcept
+{
+    const double gamma = mConfig.mRiskAversion;
+    mSkewPerLot = gamma * mVariance * mConfig.mHorizon;
+    // ln(1 + gamma / k) / gamma, with 1 / k the mean trade distance; it tends
+    // to the mean distance itself as gamma goes to zero
+    const double liquidity = gamma > 0.0 ? std::log1p(gamma * mMeanTradeDistance) / gamma : mMeanTradeDistance;
+    mHalfSpread = 0.5 * mSkewPerLot + liquidity;
+}
+
+}
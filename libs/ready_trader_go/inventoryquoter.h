@@ -0,0 +1,115 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_INVENTORYQUOTER_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_INVENTORYQUOTER_H
+
+#include "bookstate.h"
+
+namespace ReadyTraderGo {
+
+struct InventoryQuoterConfig
+{
+    // Risk aversion (gamma), per cent: the reservation price moves
+    // gamma sigma^2 T cents per lot held, with sigma^2 in cents squared per
+    // tick. The fair value's variance is around 1e4 cents squared per tick in
+    // the sample market data, so with a horizon of 5 ticks the default moves
+    // it a whole tick every 10 to 20 lots.
+    double mRiskAversion = 0.0001;
+    // Ticks over which inventory is expected to be held (T - t, held fixed
+    // since the trader has no closing time to work towards)
+    double mHorizon = 5.0;
+    // Half-lives, in ticks and in trade ticks messages, of the volatility
+    // and the trade distance averages
+    double mVolatilityHalfLife = 50.0;
+    double mIntensityHalfLife = 50.0;
+};
+
+// Prices quotes around an inventory-skewed reservation price, after
+// Avellaneda and Stoikov.
+//
+// With mid-price s, position q, risk aversion gamma, horizon T, volatility
+// sigma (per tick) and order arrival intensity A exp(-k delta) at a distance
+// delta from the mid, the reservation price and optimal half-spread are
+//
+//     r = s - q gamma sigma^2 T
+//     delta = gamma sigma^2 T / 2 + ln(1 + gamma / k) / gamma
+//
+// sigma^2 is the exponentially weighted mean squared change in the mid from
+// one tick to the next. For an exponential intensity 1 / k is the mean
+// distance from the mid at which trades happen, so that is averaged over the
+// volume in the trade ticks. The skew per lot and the half-spread are worked
+// out again only when either estimate changes, leaving a multiply-add per
+// price quoted.
+class InventoryQuoter
+{
+public:
+    InventoryQuoter() noexcept { Configure(InventoryQuoterConfig()); }
+
+    void Configure(const InventoryQuoterConfig& config) noexcept;
+
+    // Called once per tick with the mid-price quoted around, and for each
+    // trade ticks message of the instrument quoted.
+    void OnTick(double mid) noexcept;
+    void OnTradeTicks(double mid,
+                      const LevelArray& askPrices,
+                      const LevelArray& askVolumes,
+                      const LevelArray& bidPrices,
+                      const LevelArray& bidVolumes) noexcept;
+
+    // False until both the volatility and the trade distance have been seen.
+    bool IsValid() const noexcept { return mHaveVolatility && mHaveIntensity; }
+
+    double GetReservationPrice(double mid, long position) const noexcept
+    {
+        return mid - static_cast<double>(position) * mSkewPerLot;
+    }
+    double GetBidPrice(double mid, long position) const noexcept
+    {
+        return GetReservationPrice(mid, position) - mHalfSpread;
+    }
+    double GetAskPrice(double mid, long position) const noexcept
+    {
+        return GetReservationPrice(mid, position) + mHalfSpread;
+    }
+
+    double GetVariance() const noexcept { return mVariance; }
+    double GetMeanTradeDistance() const noexcept { return mMeanTradeDistance; }
+    double GetSkewPerLot() const noexcept { return mSkewPerLot; }
+    double GetHalfSpread() const noexcept { return mHalfSpread; }
+
+private:
+    void UpdateCoefficients() noexcept;
+
+    InventoryQuoterConfig mConfig;
+    double mVolatilityDecay = 0.0;
+    double mIntensityDecay = 0.0;
+
+    double mLastMid = 0.0;
+    double mVariance = 0.0;
+    double mMeanTradeDistance = 0.0;
+    bool mHaveVolatility = false;
+    bool mHaveIntensity = false;
+
+    // gamma sigma^2 T, and the optimal half-spread
+    double mSkewPerLot = 0.0;
+    double mHalfSpread = 0.0;
+};
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_INVENTORYQUOTER_H
@@ -0,0 +1,116 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_LATENCYHISTOGRAM_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_LATENCYHISTOGRAM_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace ReadyTraderGo {
+
+// A fixed-size histogram of durations in nanoseconds, cheap enough to record
+// into on a hot path.
+//
+// Values are bucketed by their most significant bit and the next two bits, so
+// percentiles are accurate to within 25% (and exact below 8ns).
+class LatencyHistogram
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void Record(std::uint64_t nanoseconds) noexcept;
+    void Record(Clock::time_point start, Clock::time_point finish) noexcept
+    {
+        Record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count()));
+    }
+
+    std::uint64_t Count() const noexcept { return mCount; }
+    std::uint64_t Max() const noexcept { return mMax; }
+    double Mean() const noexcept { return mCount ? static_cast<double>(mSum) / static_cast<double>(mCount) : 0.0; }
+
+    // An upper bound on the given fraction (0 to 1) of the recorded values.
+    std::uint64_t Percentile(double fraction) const noexcept;
+
+private:
+    static constexpr std::size_t SUB_BUCKET_BITS = 2;
+    static constexpr std::size_t BUCKET_COUNT = 64 << SUB_BUCKET_BITS;
+
+    static std::size_t BucketOf(std::uint64_t value) noexcept;
+    static std::uint64_t UpperBoundOf(std::size_t bucket) noexcept;
+
+    std::array<std::uint32_t, BUCKET_COUNT> mBuckets{};
+    std::uint64_t mCount = 0;
+    std::uint64_t mSum = 0;
+    std::uint64_t mMax = 0;
+};
+
+inline std::size_t LatencyHistogram::BucketOf(std::uint64_t value) noexcept
+{
+    if (value < (1u << (SUB_BUCKET_BITS + 1)))
+    {
+        return static_cast<std::size_t>(value);
+    }
+    const auto msb = static_cast<std::size_t>(63 - __builtin_clzll(value));
+    const auto sub = static_cast<std::size_t>(value >> (msb - SUB_BUCKET_BITS)) & ((1u << SUB_BUCKET_BITS) - 1);
+    return ((msb - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS) + sub;
+}
+
+inline std::uint64_t LatencyHistogram::UpperBoundOf(std::size_t bucket) noexcept
+{
+    if (bucket < (1u << (SUB_BUCKET_BITS + 1)))
+    {
+        return bucket;
+    }
+    const std::size_t msb = (bucket >> SUB_BUCKET_BITS) + SUB_BUCKET_BITS - 1;
+    const std::uint64_t sub = bucket & ((1u << SUB_BUCKET_BITS) - 1);
+    const std::size_t shift = msb - SUB_BUCKET_BITS;
+    return ((((std::uint64_t{1} << SUB_BUCKET_BITS) | sub) + 1) << shift) - 1;
+}
+
+inline void LatencyHistogram::Record(std::uint64_t nanoseconds) noexcept
+{
+    ++mBuckets[BucketOf(nanoseconds)];
+    ++mCount;
+    mSum += nanoseconds;
+    if (nanoseconds > mMax)
+    {
+        mMax = nanoseconds;
+    }
+}
+
+inline std::uint64_t LatencyHistogram::Percentile(double fraction) const noexcept
+{
+    const auto wanted = static_cast<std::uint64_t>(fraction * static_cast<double>(mCount) + 0.5);
+    std::uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket)
+    {
+        seen += mBuckets[bucket];
+        if (seen >= wanted && seen != 0)
+        {
+            const auto bound = UpperBoundOf(bucket);
+            return bound < mMax ? bound : mMax;
+        }
+    }
+    return mMax;
+}
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_LATENCYHISTOGRAM_H
@@ -0,0 +1,61 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+#include <cmath>
+
+#include "lotsizer.h"
+
+namespace ReadyTraderGo {
+
+void LotSizer::Configure(const LotSizerConfig& config) noexcept
+{
+    mConfig = config;
+    mConfig.mMinLot = std::max(mConfig.mMinLot, 1UL);
+    mConfig.mMaxLot = std::max(mConfig.mMaxLot, mConfig.mMinLot);
+    mConfig.mPositionLimit = std::max(mConfig.mPositionLimit, 1L);
+    mDecay = mConfig.mFillRateHalfLife > 0.0 ? std::exp2(-1.0 / mConfig.mFillRateHalfLife) : 0.0;
+    mInverseTargetFillRate = mConfig.mTargetFillRate > 0.0 ? 1.0 / mConfig.mTargetFillRate : 0.0;
+    mInversePositionLimit = 1.0 / static_cast<double>(mConfig.mPositionLimit);
+}
+
+void LotSizer::OnTick() noexcept
+{
+    for (std::size_t i = 0; i < mFillRates.size(); ++i)
+    {
+        mFillRates[i] = mDecay * mFillRates[i] + (1.0 - mDecay) * mFillVolumes[i];
+        mFillVolumes[i] = 0.0;
+    }
+}
+
+unsigned long LotSizer::Size(Side side, long position, unsigned long touchVolume) const noexcept
+{
+    const long exposure = side == Side::BUY ? position : -position;
+    const long room = mConfig.mPositionLimit - exposure;
+    if (room <= 0)
+        return 0;
+
+    double size = static_cast<double>(mConfig.mBaseLot) * static_cast<double>(room) * mInversePositionLimit;
+    if (mConfig.mDepthFraction > 0.0 && touchVolume != 0)
+        size = std::min(size, mConfig.mDepthFraction * static_cast<double>(touchVolume));
+    size /= 1.0 + GetFillRate(side) * mInverseTargetFillRate;
+
+    const auto lots = static_cast<unsigned long>(size) / mConfig.mMinLot * mConfig.mMinLot;
+    return std::min({std::clamp(lots, mConfig.mMinLot, mConfig.mMaxLot), static_cast<unsigned long>(room)});
+}
+
+}
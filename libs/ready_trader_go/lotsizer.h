@@ -0,0 +1,89 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_LOTSIZER_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_LOTSIZER_H
+
+#include <array>
+
+#include "types.h"
+
+namespace ReadyTraderGo {
+
+struct LotSizerConfig
+{
+    // Size quoted when flat, on a side that is not being filled
+    unsigned long mBaseLot = 10;
+    // Sizes are whole multiples of the minimum and no more than the maximum
+    unsigned long mMinLot = 1;
+    unsigned long mMaxLot = 50;
+    long mPositionLimit = 100;
+    // Most of the volume at the best price on our side to match (zero for
+    // no limit)
+    double mDepthFraction = 0.5;
+    // Half-life, in ticks, of the fill rates, and the fill rate (lots per
+    // tick) at which a side's size is halved
+    double mFillRateHalfLife = 20.0;
+    double mTargetFillRate = 1.0;
+};
+
+// Works out how many lots to quote at the best level on each side.
+//
+// The size starts from the base lot and scales with the room left before the
+// position limit on that side: nothing at the limit, the base lot when flat
+// and up to twice that when at the opposite limit. It is then held to a
+// fraction of the volume already at the best price on the side, so that a
+// thin book is not flooded, and shrunk as the side's recent fill rate rises
+// above the target, since fast fills are mostly informed ones.
+//
+// Fill rates are exponentially weighted per tick, with the decay factor
+// worked out when configured, so each update is a multiply-add.
+class LotSizer
+{
+public:
+    LotSizer() noexcept { Configure(LotSizerConfig()); }
+
+    void Configure(const LotSizerConfig& config) noexcept;
+
+    // Called for each fill of one of our ETF orders, and once per tick.
+    void OnFill(Side side, unsigned long volume) noexcept
+    {
+        mFillVolumes[static_cast<int>(side)] += static_cast<double>(volume);
+    }
+    void OnTick() noexcept;
+
+    // Lots to quote on the side given our position and the volume at the
+    // best price on that side. Zero if the side should not be quoted; never
+    // more than the room before the position limit.
+    unsigned long Size(Side side, long position, unsigned long touchVolume) const noexcept;
+
+    double GetFillRate(Side side) const noexcept { return mFillRates[static_cast<int>(side)]; }
+
+private:
+    LotSizerConfig mConfig;
+    double mDecay = 0.0;
+    double mInverseTargetFillRate = 0.0;
+    double mInversePositionLimit = 0.0;
+
+    // Lots filled since the last tick, and the smoothed lots per tick, by side
+    std::array<double, 2> mFillVolumes{};
+    std::array<double, 2> mFillRates{};
+};
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_LOTSIZER_H
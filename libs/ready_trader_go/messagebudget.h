@@ -0,0 +1,95 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_MESSAGEBUDGET_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_MESSAGEBUDGET_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+#include "timerwheel.h"
+
+namespace ReadyTraderGo {
+
+// The exchange's limit on messages from a trader (see exchange.json)
+constexpr std::size_t MESSAGE_FREQUENCY_LIMIT = 50;
+constexpr std::chrono::seconds MESSAGE_FREQUENCY_INTERVAL{1};
+
+// Counts the messages sent to the exchange over the last interval, as the
+// exchange's frequency limiter does (ready_trader_go/limiter.py), so that
+// messages that can wait are held back before the limit is reached. Times
+// are on the trader's timers' clock. Uses no heap memory.
+class MessageBudget
+{
+public:
+    using Clock = TimerWheel::Clock;
+
+    // More messages than this in one interval are counted as this many
+    static constexpr std::size_t CAPACITY = 2 * MESSAGE_FREQUENCY_LIMIT;
+
+    explicit MessageBudget(Clock::duration interval = MESSAGE_FREQUENCY_INTERVAL) noexcept : mInterval(interval) {}
+
+    // Count a message sent at 'now'. Times must not go backwards.
+    void Record(Clock::time_point now) noexcept;
+
+    // Messages sent in the interval up to 'now'.
+    std::size_t Count(Clock::time_point now) noexcept;
+
+    // Messages that may be sent at 'now' without the interval holding more
+    // than 'limit'.
+    std::size_t Available(Clock::time_point now, std::size_t limit) noexcept
+    {
+        const auto count = Count(now);
+        return count < limit ? limit - count : 0;
+    }
+
+private:
+    Clock::duration mInterval;
+    // Send times, oldest first from mFirst
+    std::array<Clock::time_point, CAPACITY> mTimes{};
+    std::size_t mFirst = 0;
+    std::size_t mCount = 0;
+};
+
+inline void MessageBudget::Record(Clock::time_point now) noexcept
+{
+    if (mCount == CAPACITY)
+    {
+        mFirst = (mFirst + 1) % CAPACITY;
+        --mCount;
+    }
+    mTimes[(mFirst + mCount) % CAPACITY] = now;
+    ++mCount;
+}
+
+// A message leaves the interval once it is more than a whole interval old:
+// the exchange's clock may not agree to the nanosecond with ours, so one that
+// is exactly an interval old is still counted.
+inline std::size_t MessageBudget::Count(Clock::time_point now) noexcept
+{
+    while (mCount != 0 && mTimes[mFirst] < now - mInterval)
+    {
+        mFirst = (mFirst + 1) % CAPACITY;
+        --mCount;
+    }
+    return mCount;
+}
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_MESSAGEBUDGET_H
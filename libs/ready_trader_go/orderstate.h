@@ -0,0 +1,127 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_ORDERSTATE_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_ORDERSTATE_H
+
+#include <array>
+#include <cstddef>
+
+namespace ReadyTraderGo {
+
+// Where one of our orders is in its life, as far as the exchange has told us.
+// The pending states are waiting for the exchange to act on a request.
+enum class OrderState : unsigned char
+{
+    PENDING_NEW,
+    LIVE,
+    PENDING_AMEND,
+    PENDING_CANCEL,
+    DONE
+};
+
+constexpr std::size_t ORDER_STATE_COUNT = 5;
+
+// What can happen to an order: a request we send, or what the exchange says
+// about it. The exchange follows every fill with an order status message, so
+// a status message is either the report of a fill (FILLED, or FULLY_FILLED
+// if nothing remains) or a reply to a request (ACKNOWLEDGED, or CLOSED if
+// nothing remains). REJECTED is an error message for the order.
+enum class OrderEvent : unsigned char
+{
+    AMEND_SENT,
+    CANCEL_SENT,
+    ACKNOWLEDGED,
+    CLOSED,
+    FILLED,
+    FULLY_FILLED,
+    REJECTED
+};
+
+constexpr std::size_t ORDER_EVENT_COUNT = 7;
+
+inline bool isPending(OrderState state) noexcept
+{
+    return state == OrderState::PENDING_NEW || state == OrderState::PENDING_AMEND
+           || state == OrderState::PENDING_CANCEL;
+}
+
+inline const char* orderStateName(OrderState state) noexcept
+{
+    switch (state)
+    {
+    case OrderState::PENDING_NEW:
+        return "pending_new";
+    case OrderState::LIVE:
+        return "live";
+    case OrderState::PENDING_AMEND:
+        return "pending_amend";
+    case OrderState::PENDING_CANCEL:
+        return "pending_cancel";
+    case OrderState::DONE:
+        return "done";
+    }
+    return "unknown";
+}
+
+// The order lifecycle as a table of one byte per state and event: the next
+// state, and whether the event answers the request the order was pending on.
+//
+// A cancel overrides anything pending: fills may still arrive for the order
+// until the exchange closes it. An order is acknowledged by the first thing
+// the exchange says about it, which may be a fill. An amend sent before then
+// leaves the order waiting on the insert.
+class OrderLifecycle
+{
+public:
+    struct Transition
+    {
+        OrderState mNext;
+        // The exchange has answered the pending request
+        bool mAcknowledges;
+    };
+
+    static Transition Apply(OrderState state, OrderEvent event) noexcept
+    {
+        const unsigned char entry = TABLE[static_cast<std::size_t>(state)][static_cast<std::size_t>(event)];
+        return {static_cast<OrderState>(entry & STATE_MASK), (entry & ACK) != 0};
+    }
+
+private:
+    static constexpr unsigned char STATE_MASK = 0x07;
+    static constexpr unsigned char ACK = 0x80;
+
+    static constexpr unsigned char NEW = static_cast<unsigned char>(OrderState::PENDING_NEW);
+    static constexpr unsigned char LIV = static_cast<unsigned char>(OrderState::LIVE);
+    static constexpr unsigned char AMD = static_cast<unsigned char>(OrderState::PENDING_AMEND);
+    static constexpr unsigned char CXL = static_cast<unsigned char>(OrderState::PENDING_CANCEL);
+    static constexpr unsigned char END = static_cast<unsigned char>(OrderState::DONE);
+
+    // Columns: AMEND_SENT, CANCEL_SENT, ACKNOWLEDGED, CLOSED, FILLED,
+    // FULLY_FILLED, REJECTED
+    static constexpr std::array<std::array<unsigned char, ORDER_EVENT_COUNT>, ORDER_STATE_COUNT> TABLE{{
+        /* PENDING_NEW */    {NEW, CXL, LIV | ACK, END | ACK, LIV | ACK, END | ACK, END | ACK},
+        /* LIVE */           {AMD, CXL, LIV,       END,       LIV,       END,       LIV},
+        /* PENDING_AMEND */  {AMD, CXL, LIV | ACK, END | ACK, AMD,       END,       LIV | ACK},
+        /* PENDING_CANCEL */ {CXL, CXL, CXL,       END | ACK, CXL,       END,       END | ACK},
+        /* DONE */           {END, END, END,       END,       END,       END,       END},
+    }};
+};
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_ORDERSTATE_H
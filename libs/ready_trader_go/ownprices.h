@@ -0,0 +1,166 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_OWNPRICES_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_OWNPRICES_H
+
+#include <array>
+#include <cstddef>
+
+#include "types.h"
+
+namespace ReadyTraderGo {
+
+// The prices at which we have orders resting on each side of a book, so that
+// an order that would trade with our own can be caught before it is sent.
+//
+// Each side is a short array of price levels, best first, with the number of
+// our orders at each. The exchange allows only a handful of active orders, so
+// adding and removing is a shift of a few elements, and the check against
+// the best price on the other side is O(1).
+class OwnPriceLevels
+{
+public:
+    static constexpr std::size_t MAX_LEVELS = 16;
+
+    // Held by an order while it counts at its price. An order stops counting
+    // when the entry is released or destroyed, so it may be erased from
+    // whatever container owns it without the levels being told. Copies start
+    // out empty, and assignment leaves the target's entry alone.
+    class Entry
+    {
+    public:
+        Entry() noexcept = default;
+        Entry(const Entry&) noexcept {}
+        Entry& operator=(const Entry&) noexcept { return *this; }
+        ~Entry() { Release(); }
+
+        bool IsHeld() const noexcept { return mLevels != nullptr; }
+
+        void Release() noexcept
+        {
+            if (mLevels != nullptr)
+            {
+                mLevels->Remove(mSide, mPrice);
+                mLevels = nullptr;
+            }
+        }
+
+    private:
+        friend class OwnPriceLevels;
+
+        OwnPriceLevels* mLevels = nullptr;
+        Side mSide = Side::BUY;
+        unsigned long mPrice = 0;
+    };
+
+    OwnPriceLevels() = default;
+    OwnPriceLevels(const OwnPriceLevels&) = delete;
+    void operator=(const OwnPriceLevels&) = delete;
+
+    // Count an order at its price. Returns false, leaving the entry empty, if
+    // the side already has MAX_LEVELS prices.
+    bool Add(Entry& entry, Side side, unsigned long price) noexcept;
+
+    // Our best resting prices, or zero if there are none on the side.
+    unsigned long BestBid() const noexcept { return Best(Side::BUY); }
+    unsigned long BestAsk() const noexcept { return Best(Side::SELL); }
+
+    // True if an order at the price would trade with one of our own.
+    bool WouldCross(Side side, unsigned long price) const noexcept
+    {
+        if (side == Side::BUY)
+            return mCounts[SELL] != 0 && price >= mLevels[SELL][0].mPrice;
+        return mCounts[BUY] != 0 && price <= mLevels[BUY][0].mPrice;
+    }
+
+private:
+    static constexpr std::size_t SELL = static_cast<std::size_t>(Side::SELL);
+    static constexpr std::size_t BUY = static_cast<std::size_t>(Side::BUY);
+
+    struct Level
+    {
+        unsigned long mPrice = 0;
+        unsigned long mOrderCount = 0;
+    };
+
+    unsigned long Best(Side side) const noexcept
+    {
+        const auto s = static_cast<std::size_t>(side);
+        return mCounts[s] != 0 ? mLevels[s][0].mPrice : 0;
+    }
+
+    static bool IsBetter(Side side, unsigned long price, unsigned long than) noexcept
+    {
+        return side == Side::BUY ? price > than : price < than;
+    }
+
+    void Remove(Side side, unsigned long price) noexcept;
+
+    std::array<std::array<Level, MAX_LEVELS>, 2> mLevels{};
+    std::array<std::size_t, 2> mCounts{};
+};
+
+inline bool OwnPriceLevels::Add(Entry& entry, Side side, unsigned long price) noexcept
+{
+    entry.Release();
+
+    const auto s = static_cast<std::size_t>(side);
+    auto& levels = mLevels[s];
+    std::size_t i = 0;
+    while (i < mCounts[s] && IsBetter(side, levels[i].mPrice, price))
+        ++i;
+
+    if (i == mCounts[s] || levels[i].mPrice != price)
+    {
+        if (mCounts[s] == MAX_LEVELS)
+            return false;
+        for (std::size_t j = mCounts[s]; j > i; --j)
+            levels[j] = levels[j - 1];
+        levels[i] = {price, 0};
+        ++mCounts[s];
+    }
+    ++levels[i].mOrderCount;
+
+    entry.mLevels = this;
+    entry.mSide = side;
+    entry.mPrice = price;
+    return true;
+}
+
+inline void OwnPriceLevels::Remove(Side side, unsigned long price) noexcept
+{
+    const auto s = static_cast<std::size_t>(side);
+    auto& levels = mLevels[s];
+    for (std::size_t i = 0; i < mCounts[s]; ++i)
+    {
+        if (levels[i].mPrice == price)
+        {
+            if (--levels[i].mOrderCount == 0)
+            {
+                for (std::size_t j = i + 1; j < mCounts[s]; ++j)
+                    levels[j - 1] = levels[j];
+                --mCounts[s];
+            }
+            return;
+        }
+    }
+}
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_OWNPRICES_H
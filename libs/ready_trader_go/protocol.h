@@ -21,11 +21,15 @@
 #include <array>
 #include <cstddef>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include "connectivitytypes.h"
+#include "error.h"
+#include "fixedstring.h"
 #include "types.h"
+#include "wireschema.h"
 
 namespace ReadyTraderGo {
 
@@ -51,53 +55,48 @@ enum MessageFieldSize : std::size_t
     STRING = 50
 };
 
-struct AmendMessage : ISerialisable
+using MessageString = FixedString<MessageFieldSize::STRING>;
+
+// Each message's wire layout is given by its Schema: a list of its fields in
+// the order they are sent.
+
+struct AmendMessage : WireMessage<AmendMessage>
 {
     AmendMessage() = default;
     AmendMessage(unsigned long clientOrderId, unsigned long newVolume)
         : mClientOrderId(clientOrderId), mNewVolume(newVolume) {}
 
-    std::size_t Size() const noexcept override { return MessageFieldSize::LONG * 2; }
-
-    void Deserialise(unsigned char const* data, std::size_t size) override;
-    void Serialise(unsigned char* buf) const override;
-
     unsigned long mClientOrderId = 0;
     unsigned long mNewVolume = 0;
+
+    using Schema = WireSchema<WireLong<&AmendMessage::mClientOrderId>,
+                              WireLong<&AmendMessage::mNewVolume>>;
 };
 
-struct CancelMessage : ISerialisable
+struct CancelMessage : WireMessage<CancelMessage>
 {
     CancelMessage() = default;
     explicit CancelMessage(unsigned long clientOrderId) : mClientOrderId(clientOrderId) {}
 
-    std::size_t Size() const noexcept override { return MessageFieldSize::LONG; }
-
-    void Deserialise(unsigned char const* data, std::size_t size) override;
-    void Serialise(unsigned char* buf) const override;
-
     unsigned long mClientOrderId = 0;
+
+    using Schema = WireSchema<WireLong<&CancelMessage::mClientOrderId>>;
 };
 
-struct ErrorMessage : ISerialisable
+struct ErrorMessage : WireMessage<ErrorMessage>
 {
     ErrorMessage() = default;
-    ErrorMessage(unsigned long clientOrderId, std::string message)
-        : mClientOrderId(clientOrderId), mMessage(std::move(message)) {}
-
-    std::size_t Size() const noexcept override
-    {
-        return MessageFieldSize::LONG + MessageFieldSize::STRING;
-    }
-
-    void Deserialise(unsigned char const* data, std::size_t size) override;
-    void Serialise(unsigned char* buf) const override;
+    ErrorMessage(unsigned long clientOrderId, std::string_view message)
+        : mClientOrderId(clientOrderId), mMessage(message) {}
 
     unsigned long mClientOrderId = 0;
-    std::string mMessage;
+    MessageString mMessage;
+
+    using Schema = WireSchema<WireLong<&ErrorMessage::mClientOrderId>,
+                              WireString<&ErrorMessage::mMessage>>;
 };
 
-struct HedgeMessage : ISerialisable
+struct HedgeMessage : WireMessage<HedgeMessage>
 {
     HedgeMessage() = default;
     HedgeMessage(unsigned long clientOrderId,
@@ -109,18 +108,18 @@ struct HedgeMessage : ISerialisable
           mPrice(price),
           mVolume(volume) {}
 
-    std::size_t Size() const noexcept override { return MessageFieldSize::LONG * 3 + MessageFieldSize::BYTE; }
-
-    void Deserialise(unsigned char const* data, std::size_t size) override;
-    void Serialise(unsigned char* buf) const override;
-
     unsigned long mClientOrderId = 0;
     Side mSide = Side::SELL;
     unsigned long mPrice = 0;
     unsigned long mVolume = 0;
+
+    using Schema = WireSchema<WireLong<&HedgeMessage::mClientOrderId>,
+                              WireByte<&HedgeMessage::mSide>,
+                              WireLong<&HedgeMessage::mPrice>,
+                              WireLong<&HedgeMessage::mVolume>>;
 };
 
-struct HedgeFilledMessage : ISerialisable
+struct HedgeFilledMessage : WireMessage<HedgeFilledMessage>
 {
     HedgeFilledMessage() = default;
     HedgeFilledMessage(unsigned long clientOrderId,
@@ -130,17 +129,16 @@ struct HedgeFilledMessage : ISerialisable
           mPrice(price),
           mVolume(volume) {}
 
-    std::size_t Size() const noexcept override { return MessageFieldSize::LONG * 3; }
-
-    void Deserialise(unsigned char const* data, std::size_t size) override;
-    void Serialise(unsigned char* buf) const override;
-
     unsigned long mClientOrderId = 0;
     unsigned long mPrice = 0;
     unsigned long mVolume = 0;
+
+    using Schema = WireSchema<WireLong<&HedgeFilledMessage::mClientOrderId>,
+                              WireLong<&HedgeFilledMessage::mPrice>,
+                              WireLong<&HedgeFilledMessage::mVolume>>;
 };
 
-struct InsertMessage : ISerialisable
+struct InsertMessage : WireMessage<InsertMessage>
 {
     InsertMessage() = default;
     InsertMessage(unsigned long clientOrderId,
@@ -154,37 +152,33 @@ struct InsertMessage : ISerialisable
           mVolume(volume),
           mLifespan(lifespan) {}
 
-    std::size_t Size() const noexcept override { return MessageFieldSize::LONG * 3 + MessageFieldSize::BYTE * 2; }
-
-    void Deserialise(unsigned char const* data, std::size_t size) override;
-    void Serialise(unsigned char* buf) const override;
-
     unsigned long mClientOrderId = 0;
     Side mSide = Side::SELL;
     unsigned long mPrice = 0;
     unsigned long mVolume = 0;
     Lifespan mLifespan = Lifespan::FILL_AND_KILL;
+
+    using Schema = WireSchema<WireLong<&InsertMessage::mClientOrderId>,
+                              WireByte<&InsertMessage::mSide>,
+                              WireLong<&InsertMessage::mPrice>,
+                              WireLong<&InsertMessage::mVolume>,
+                              WireByte<&InsertMessage::mLifespan>>;
 };
 
-struct LoginMessage : ISerialisable
+struct LoginMessage : WireMessage<LoginMessage>
 {
     LoginMessage() = default;
-    LoginMessage(std::string name, std::string secret)
-        : mName(std::move(name)), mSecret(std::move(secret)) {}
+    LoginMessage(std::string_view name, std::string_view secret)
+        : mName(name), mSecret(secret) {}
 
-    std::size_t Size() const noexcept override
-    {
-        return MessageFieldSize::STRING * 2;
-    }
-
-    void Deserialise(unsigned char const* data, std::size_t size) override;
-    void Serialise(unsigned char* buf) const override;
+    MessageString mName;
+    MessageString mSecret;
 
-    std::string mName;
-    std::string mSecret;
+    using Schema = WireSchema<WireString<&LoginMessage::mName>,
+                              WireString<&LoginMessage::mSecret>>;
 };
 
-struct OrderBookMessage : ISerialisable
+struct OrderBookMessage : WireMessage<OrderBookMessage>
 {
     OrderBookMessage() = default;
     OrderBookMessage(Instrument instrument,
@@ -200,25 +194,22 @@ struct OrderBookMessage : ISerialisable
           mBidPrices(bidPrices),
           mBidVolumes(bidVolumes) {}
 
-    std::size_t Size() const noexcept override
-    {
-        return MessageFieldSize::BYTE
-            + MessageFieldSize::LONG
-            + MessageFieldSize::LONG * TOP_LEVEL_COUNT * 4;
-    }
-
-    void Deserialise(unsigned char const* data, std::size_t size) override;
-    void Serialise(unsigned char* buf) const override;
-
     Instrument mInstrument = Instrument::FUTURE;
     unsigned long mSequenceNumber = 0;
     std::array<unsigned long, TOP_LEVEL_COUNT> mAskPrices = {};
     std::array<unsigned long, TOP_LEVEL_COUNT> mAskVolumes = {};
     std::array<unsigned long, TOP_LEVEL_COUNT> mBidPrices = {};
     std::array<unsigned long, TOP_LEVEL_COUNT> mBidVolumes = {};
+
+    using Schema = WireSchema<WireByte<&OrderBookMessage::mInstrument>,
+                              WireLong<&OrderBookMessage::mSequenceNumber>,
+                              WireLongArray<&OrderBookMessage::mAskPrices>,
+                              WireLongArray<&OrderBookMessage::mAskVolumes>,
+                              WireLongArray<&OrderBookMessage::mBidPrices>,
+                              WireLongArray<&OrderBookMessage::mBidVolumes>>;
 };
 
-struct OrderFilledMessage : ISerialisable
+struct OrderFilledMessage : WireMessage<OrderFilledMessage>
 {
     OrderFilledMessage() = default;
     OrderFilledMessage(unsigned long clientOrderId,
@@ -228,17 +219,16 @@ struct OrderFilledMessage : ISerialisable
           mPrice(price),
           mVolume(volume) {}
 
-    std::size_t Size() const noexcept override { return MessageFieldSize::LONG * 3; }
-
-    void Deserialise(unsigned char const* data, std::size_t size) override;
-    void Serialise(unsigned char* buf) const override;
-
     unsigned long mClientOrderId = 0;
     unsigned long mPrice = 0;
     unsigned long mVolume = 0;
+
+    using Schema = WireSchema<WireLong<&OrderFilledMessage::mClientOrderId>,
+                              WireLong<&OrderFilledMessage::mPrice>,
+                              WireLong<&OrderFilledMessage::mVolume>>;
 };
 
-struct OrderStatusMessage : ISerialisable
+struct OrderStatusMessage : WireMessage<OrderStatusMessage>
 {
     OrderStatusMessage() = default;
     OrderStatusMessage(unsigned long clientOrderId,
@@ -250,18 +240,18 @@ struct OrderStatusMessage : ISerialisable
           mRemainingVolume(remainingVolume),
           mFees(fees) {}
 
-    std::size_t Size() const noexcept override { return MessageFieldSize::LONG * 4; }
-
-    void Deserialise(unsigned char const* data, std::size_t size) override;
-    void Serialise(unsigned char* buf) const override;
-
     unsigned long mClientOrderId = 0;
     unsigned long mFillVolume = 0;
     unsigned long mRemainingVolume = 0;
     signed long mFees = 0;
+
+    using Schema = WireSchema<WireLong<&OrderStatusMessage::mClientOrderId>,
+                              WireLong<&OrderStatusMessage::mFillVolume>,
+                              WireLong<&OrderStatusMessage::mRemainingVolume>,
+                              WireLong<&OrderStatusMessage::mFees>>;
 };
 
-struct TradeTicksMessage : ISerialisable
+struct TradeTicksMessage : WireMessage<TradeTicksMessage>
 {
     TradeTicksMessage() = default;
     TradeTicksMessage(Instrument instrument,
@@ -277,29 +267,32 @@ struct TradeTicksMessage : ISerialisable
               mBidPrices(bidPrices),
               mBidVolumes(bidVolumes) {}
 
-    std::size_t Size() const noexcept override
-    {
-        return MessageFieldSize::BYTE
-               + MessageFieldSize::LONG
-               + MessageFieldSize::LONG * TOP_LEVEL_COUNT * 4;
-    }
-
-    void Deserialise(unsigned char const* data, std::size_t size) override;
-    void Serialise(unsigned char* buf) const override;
-
     Instrument mInstrument = Instrument::FUTURE;
     unsigned long mSequenceNumber = 0;
     std::array<unsigned long, TOP_LEVEL_COUNT> mAskPrices = {};
     std::array<unsigned long, TOP_LEVEL_COUNT> mAskVolumes = {};
     std::array<unsigned long, TOP_LEVEL_COUNT> mBidPrices = {};
     std::array<unsigned long, TOP_LEVEL_COUNT> mBidVolumes = {};
+
+    using Schema = WireSchema<WireByte<&TradeTicksMessage::mInstrument>,
+                              WireLong<&TradeTicksMessage::mSequenceNumber>,
+                              WireLongArray<&TradeTicksMessage::mAskPrices>,
+                              WireLongArray<&TradeTicksMessage::mAskVolumes>,
+                              WireLongArray<&TradeTicksMessage::mBidPrices>,
+                              WireLongArray<&TradeTicksMessage::mBidVolumes>>;
 };
 
+// Deserialise a message of type T. Any bytes beyond the message's size are
+// ignored but a truncated message is an error.
 template<class T>
 T makeMessage(unsigned char const* data, std::size_t size)
 {
+    if (size < T::Schema::SIZE)
+    {
+        throw ReadyTraderGoError("truncated message");
+    }
     T message;
-    message.Deserialise(data, size);
+    T::Schema::Deserialise(message, data);
     return message;
 }
 
@@ -0,0 +1,144 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_QUEUEPOSITION_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_QUEUEPOSITION_H
+
+#include <cstddef>
+
+#include "bookstate.h"
+#include "types.h"
+
+namespace ReadyTraderGo {
+
+// An estimate of the volume queued ahead of one of our resting orders at its
+// price level, maintained incrementally from the information feed.
+//
+// When the order is inserted, everything visible at its price is ahead of it.
+// Volume traded at that price (from trade ticks) comes off the front of the
+// queue, and trading through the price empties it. Any further shrinkage of
+// the level seen in the next order book snapshot is taken to be cancellations
+// spread evenly through the queue, so only the share in front of the order
+// counts.
+class QueuePosition
+{
+public:
+    QueuePosition() = default;
+    QueuePosition(Side side, unsigned long price, unsigned long levelVolume) noexcept
+        : mSide(side), mPrice(price), mVolumeAhead(levelVolume), mOthersAtLevel(levelVolume) {}
+
+    Side GetSide() const noexcept { return mSide; }
+    unsigned long GetPrice() const noexcept { return mPrice; }
+    unsigned long VolumeAhead() const noexcept { return mVolumeAhead; }
+    bool AtFront() const noexcept { return mVolumeAhead == 0; }
+
+    // Apply a trade ticks message for the order's instrument.
+    void OnTradeTicks(const LevelArray& askPrices,
+                      const LevelArray& askVolumes,
+                      const LevelArray& bidPrices,
+                      const LevelArray& bidVolumes) noexcept;
+
+    // Apply an order book snapshot for the order's instrument, given the
+    // order's own remaining (unfilled) volume.
+    void OnOrderBook(const BookState& book, unsigned long remainingVolume) noexcept;
+
+private:
+    Side mSide = Side::BUY;
+    unsigned long mPrice = 0;
+    unsigned long mVolumeAhead = 0;
+    // Volume of other orders at the price in the last snapshot, and the part
+    // of it traded away since.
+    unsigned long mOthersAtLevel = 0;
+    unsigned long mTradedSinceSnapshot = 0;
+};
+
+// Return the volume at 'price' on one side of a book, or zero if the price is
+// not one of the visible levels.
+inline unsigned long VolumeAtPrice(const LevelArray& prices, const LevelArray& volumes, unsigned long price) noexcept
+{
+    for (std::size_t i = 0; i < TOP_LEVEL_COUNT; ++i)
+    {
+        if (prices[i] == price)
+        {
+            return volumes[i];
+        }
+    }
+    return 0;
+}
+
+inline void QueuePosition::OnTradeTicks(const LevelArray& askPrices,
+                                        const LevelArray& askVolumes,
+                                        const LevelArray& bidPrices,
+                                        const LevelArray& bidVolumes) noexcept
+{
+    // Resting sell orders trade against buyers and appear as ask ticks, and
+    // resting buy orders as bid ticks. Ticks are ordered best price first.
+    const bool isSell = mSide == Side::SELL;
+    const LevelArray& prices = isSell ? askPrices : bidPrices;
+    const LevelArray& volumes = isSell ? askVolumes : bidVolumes;
+
+    unsigned long traded = 0;
+    for (std::size_t i = 0; i < TOP_LEVEL_COUNT && prices[i] != 0; ++i)
+    {
+        if (prices[i] == mPrice)
+        {
+            traded = volumes[i];
+        }
+        else if (isSell ? prices[i] > mPrice : prices[i] < mPrice)
+        {
+            // The whole level traded
+            mVolumeAhead = 0;
+            mTradedSinceSnapshot = mOthersAtLevel;
+            return;
+        }
+    }
+
+    mVolumeAhead = (traded < mVolumeAhead) ? mVolumeAhead - traded : 0;
+    mTradedSinceSnapshot += traded;
+}
+
+inline void QueuePosition::OnOrderBook(const BookState& book, unsigned long remainingVolume) noexcept
+{
+    const unsigned long level = (mSide == Side::SELL)
+                                ? VolumeAtPrice(book.GetAskPrices(), book.GetAskVolumes(), mPrice)
+                                : VolumeAtPrice(book.GetBidPrices(), book.GetBidVolumes(), mPrice);
+    const unsigned long others = (level > remainingVolume) ? level - remainingVolume : 0;
+
+    // Shrinkage not explained by trades is cancellations, some of which were
+    // in front of us
+    const unsigned long expected = (mTradedSinceSnapshot < mOthersAtLevel)
+                                   ? mOthersAtLevel - mTradedSinceSnapshot : 0;
+    if (others < expected && mVolumeAhead != 0)
+    {
+        const unsigned long cancelled = expected - others;
+        const unsigned long cancelledAhead = static_cast<unsigned long>(
+            static_cast<double>(cancelled) * static_cast<double>(mVolumeAhead) / static_cast<double>(expected) + 0.5);
+        mVolumeAhead = (cancelledAhead < mVolumeAhead) ? mVolumeAhead - cancelledAhead : 0;
+    }
+
+    // Nothing can be ahead of us that is not at the level
+    if (mVolumeAhead > others)
+    {
+        mVolumeAhead = others;
+    }
+    mOthersAtLevel = others;
+    mTradedSinceSnapshot = 0;
+}
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_QUEUEPOSITION_H
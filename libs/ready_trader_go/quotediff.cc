@@ -0,0 +1,132 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include "quotediff.h"
+
+namespace ReadyTraderGo {
+
+std::size_t QuoteDiffer::Diff(const QuoteLevels& target,
+                              const LiveQuote* live,
+                              std::size_t liveCount,
+                              Actions& actions,
+                              std::size_t maxOrders) noexcept
+{
+    if (liveCount > MAX_LIVE_QUOTES)
+    {
+        liveCount = MAX_LIVE_QUOTES;
+    }
+
+    QuoteAction cancels[MAX_LIVE_QUOTES];
+    QuoteAction amends[MAX_LIVE_QUOTES];
+    std::size_t cancelCount = 0;
+    std::size_t amendCount = 0;
+    std::size_t count = 0;
+    unsigned long targetCount = 0;
+
+    // Target volume not yet covered by live orders, whether any live order
+    // is kept, and the newest order kept whole, per level
+    unsigned long uncovered[MAX_QUOTE_LEVELS];
+    bool kept[MAX_QUOTE_LEVELS] = {};
+    const LiveQuote* newest[MAX_QUOTE_LEVELS] = {};
+    for (std::size_t level = 0; level < MAX_QUOTE_LEVELS; ++level)
+    {
+        uncovered[level] = target[level].mVolume;
+        targetCount += (target[level].mVolume != 0);
+    }
+
+    // Oldest orders at a price are matched first, so the ones shed are the
+    // ones with the least queue priority
+    for (std::size_t i = 0; i < liveCount; ++i)
+    {
+        const LiveQuote& order = live[i];
+        std::size_t level = 0;
+        while (level < MAX_QUOTE_LEVELS && (target[level].mVolume == 0 || target[level].mPrice != order.mPrice))
+        {
+            ++level;
+        }
+
+        const unsigned long wanted = (level < MAX_QUOTE_LEVELS) ? uncovered[level] : 0;
+        if (wanted == 0)
+        {
+            cancels[cancelCount++] = {QuoteActionType::CANCEL, order.mClientOrderId, order.mPrice, 0};
+        }
+        else if (order.mRemainingVolume > wanted)
+        {
+            amends[amendCount++] = {QuoteActionType::AMEND, order.mClientOrderId, order.mPrice, wanted};
+            uncovered[level] = 0;
+            kept[level] = true;
+        }
+        else
+        {
+            uncovered[level] -= order.mRemainingVolume;
+            kept[level] = true;
+            newest[level] = &order;
+        }
+    }
+
+    // New levels first, then top-ups of levels that are already quoted,
+    // replacing an order if there is no room for another
+    QuoteAction inserts[MAX_QUOTE_LEVELS];
+    std::size_t insertCount = 0;
+    std::size_t resting = liveCount - cancelCount;
+    mIsCovered = true;
+    for (bool topUps : {false, true})
+    {
+        for (std::size_t level = 0; level < MAX_QUOTE_LEVELS; ++level)
+        {
+            if (uncovered[level] == 0 || kept[level] != topUps)
+            {
+                continue;
+            }
+            if (resting < maxOrders)
+            {
+                inserts[insertCount++] = {QuoteActionType::INSERT, 0, target[level].mPrice, uncovered[level]};
+                ++resting;
+            }
+            else if (newest[level] != nullptr)
+            {
+                const LiveQuote& order = *newest[level];
+                cancels[cancelCount++] = {QuoteActionType::CANCEL, order.mClientOrderId, order.mPrice, 0};
+                inserts[insertCount++] = {QuoteActionType::INSERT, 0, target[level].mPrice,
+                                          uncovered[level] + order.mRemainingVolume};
+            }
+            else
+            {
+                mIsCovered = false;
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < cancelCount; ++i)
+    {
+        actions[count++] = cancels[i];
+    }
+    for (std::size_t i = 0; i < amendCount; ++i)
+    {
+        actions[count++] = amends[i];
+    }
+    for (std::size_t i = 0; i < insertCount; ++i)
+    {
+        actions[count++] = inserts[i];
+    }
+
+    mStats.mMessagesSent += count;
+    mStats.mMessagesAvoided += liveCount + targetCount - count;
+    return count;
+}
+
+}
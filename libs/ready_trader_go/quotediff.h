@@ -0,0 +1,125 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_QUOTEDIFF_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_QUOTEDIFF_H
+
+#include <array>
+#include <cstddef>
+
+#include "types.h"
+
+namespace ReadyTraderGo {
+
+constexpr std::size_t MAX_QUOTE_LEVELS = 5;
+constexpr std::size_t MAX_LIVE_QUOTES = 10;
+constexpr std::size_t MAX_QUOTE_ACTIONS = MAX_QUOTE_LEVELS + MAX_LIVE_QUOTES;
+
+// A desired resting quote. A volume of zero means no quote.
+struct Quote
+{
+    unsigned long mPrice = 0;
+    unsigned long mVolume = 0;
+
+    bool operator==(const Quote& other) const noexcept
+    {
+        return mPrice == other.mPrice && mVolume == other.mVolume;
+    }
+    bool operator!=(const Quote& other) const noexcept { return !(*this == other); }
+};
+
+// The desired quotes on one side of the book, best level first.
+using QuoteLevels = std::array<Quote, MAX_QUOTE_LEVELS>;
+
+// One of our resting orders, with the volume still to trade. Orders at the
+// same price should be given oldest first.
+struct LiveQuote
+{
+    unsigned long mClientOrderId = 0;
+    unsigned long mPrice = 0;
+    unsigned long mRemainingVolume = 0;
+};
+
+enum class QuoteActionType : unsigned char { CANCEL, AMEND, INSERT };
+
+struct QuoteAction
+{
+    QuoteActionType mType = QuoteActionType::INSERT;
+    // Order to cancel or amend
+    unsigned long mClientOrderId = 0;
+    // Price of an insert
+    unsigned long mPrice = 0;
+    // Volume of an insert, or the remaining volume an amended order is left with
+    unsigned long mVolume = 0;
+};
+
+struct QuoteDiffStats
+{
+    // Messages needed to bring the live orders to the targets
+    unsigned long mMessagesSent = 0;
+    // Messages a cancel-and-replace of every live order would have needed
+    // on top of those
+    unsigned long mMessagesAvoided = 0;
+};
+
+// Works out the fewest messages that turn the live orders on one side into
+// the target quotes.
+//
+// Live volume at a target price is kept where possible so that it keeps its
+// place in the queue: surplus volume is taken from the newest orders at the
+// price (amending them down, or cancelling them) and a shortfall is made up
+// with a new order. Orders at prices with no target are cancelled. So moving
+// a ladder of equal volumes by one level costs one cancel at the far end and
+// one insert at the near end. If the volumes grow away from the best price,
+// every level that moves closer to it also falls short, so a move towards
+// the best price costs an insert per level as well, and a move away an amend
+// per level, or a cancel per level of the orders that made up the shortfall.
+//
+// No more than 'maxOrders' orders are left resting: new levels are inserted
+// nearest first, then shortfalls at levels that already have an order are
+// made up. Once there is no room for another order, a shortfall is made up by
+// replacing the level's newest order, which has the least queue priority,
+// with one for its volume and the shortfall together. Actions are ordered
+// cancels, then amends, then inserts, so that the exchange's volume and order
+// count limits are never exceeded on the way.
+class QuoteDiffer
+{
+public:
+    using Actions = std::array<QuoteAction, MAX_QUOTE_ACTIONS>;
+
+    // Write the actions to 'actions' and return how many there are. At most
+    // MAX_LIVE_QUOTES live orders are considered.
+    std::size_t Diff(const QuoteLevels& target,
+                     const LiveQuote* live,
+                     std::size_t liveCount,
+                     Actions& actions,
+                     std::size_t maxOrders = MAX_LIVE_QUOTES) noexcept;
+
+    // Whether the actions from the last Diff bring every level up to its
+    // target volume, which they may not if there is no room for an order.
+    bool IsCovered() const noexcept { return mIsCovered; }
+
+    const QuoteDiffStats& GetStats() const noexcept { return mStats; }
+
+private:
+    QuoteDiffStats mStats;
+    bool mIsCovered = true;
+};
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_QUOTEDIFF_H
@@ -0,0 +1,126 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_RINGBUFFER_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_RINGBUFFER_H
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+
+namespace ReadyTraderGo {
+
+struct RingBufferStats
+{
+    std::size_t mHighWaterMark = 0;
+    std::size_t mWraps = 0;
+    std::size_t mOverflows = 0;
+};
+
+// A fixed-capacity byte buffer that is allocated once, on construction.
+//
+// Readable bytes always occupy the contiguous region [Data(), Data() + Size())
+// and writable space is always the contiguous region returned by Prepare().
+// When a write would run past the end of the storage, the (small) unconsumed
+// remainder is moved back to the start of the buffer - this is counted as a
+// wrap. When the buffer drains completely the positions are simply reset.
+//
+// Wrapping moves the readable bytes, so callers with an outstanding operation
+// referring to them (e.g. an asynchronous write) must pass canWrap=false and
+// call Compact() once that operation has completed.
+class RingBuffer
+{
+public:
+    explicit RingBuffer(std::size_t capacity)
+        : mStorage(new unsigned char[capacity]), mCapacity(capacity) {}
+
+    RingBuffer(const RingBuffer&) = delete;
+    void operator=(const RingBuffer&) = delete;
+
+    std::size_t Capacity() const noexcept { return mCapacity; }
+    unsigned char* Data() noexcept { return mStorage.get() + mHead; }
+    unsigned char const* Data() const noexcept { return mStorage.get() + mHead; }
+    std::size_t Size() const noexcept { return mTail - mHead; }
+    std::size_t Writable() const noexcept { return mCapacity - mTail; }
+    const RingBufferStats& GetStats() const noexcept { return mStats; }
+
+    // Return a pointer to at least 'size' contiguous writable bytes, or
+    // nullptr if the buffer cannot hold that many more bytes.
+    unsigned char* Prepare(std::size_t size, bool canWrap = true) noexcept;
+
+    void Commit(std::size_t size) noexcept;
+    void Consume(std::size_t size) noexcept;
+
+    // Move any unconsumed bytes back to the start of the buffer, so that all
+    // the free space is writable.
+    void Compact() noexcept;
+
+private:
+    std::unique_ptr<unsigned char[]> mStorage;
+    std::size_t mCapacity;
+    std::size_t mHead = 0;
+    std::size_t mTail = 0;
+    RingBufferStats mStats;
+};
+
+inline unsigned char* RingBuffer::Prepare(std::size_t size, bool canWrap) noexcept
+{
+    if (mCapacity - mTail < size)
+    {
+        if (!canWrap || mCapacity - Size() < size)
+        {
+            ++mStats.mOverflows;
+            return nullptr;
+        }
+        Compact();
+    }
+    return mStorage.get() + mTail;
+}
+
+inline void RingBuffer::Commit(std::size_t size) noexcept
+{
+    mTail += size;
+    if (Size() > mStats.mHighWaterMark)
+    {
+        mStats.mHighWaterMark = Size();
+    }
+}
+
+inline void RingBuffer::Compact() noexcept
+{
+    if (mHead == 0)
+    {
+        return;
+    }
+    std::memmove(mStorage.get(), mStorage.get() + mHead, Size());
+    mTail -= mHead;
+    mHead = 0;
+    ++mStats.mWraps;
+}
+
+inline void RingBuffer::Consume(std::size_t size) noexcept
+{
+    mHead += size;
+    if (mHead == mTail)
+    {
+        mHead = mTail = 0;
+    }
+}
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_RINGBUFFER_H
@@ -0,0 +1,97 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_SPSCQUEUE_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_SPSCQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace ReadyTraderGo {
+
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+// A bounded, lock-free queue for passing values from exactly one producer
+// thread to exactly one consumer thread. Each side keeps a cached copy of
+// the other side's position so that the shared positions are only read
+// when the queue looks full (or empty).
+template<typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    SpscQueue() = default;
+    SpscQueue(const SpscQueue&) = delete;
+    void operator=(const SpscQueue&) = delete;
+
+    // Producer side. Returns false, without copying the item, if full.
+    bool TryPush(const T& item) noexcept;
+
+    // Consumer side. Returns false if empty.
+    bool TryPop(T& item) noexcept;
+
+private:
+    // Written by the consumer
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> mHead{0};
+    std::size_t mCachedTail = 0;
+
+    // Written by the producer
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> mTail{0};
+    std::size_t mCachedHead = 0;
+
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> mItems;
+};
+
+template<typename T, std::size_t Capacity>
+inline bool SpscQueue<T, Capacity>::TryPush(const T& item) noexcept
+{
+    const std::size_t tail = mTail.load(std::memory_order_relaxed);
+    if (tail - mCachedHead == Capacity)
+    {
+        mCachedHead = mHead.load(std::memory_order_acquire);
+        if (tail - mCachedHead == Capacity)
+        {
+            return false;
+        }
+    }
+    mItems[tail & (Capacity - 1)] = item;
+    mTail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T, std::size_t Capacity>
+inline bool SpscQueue<T, Capacity>::TryPop(T& item) noexcept
+{
+    const std::size_t head = mHead.load(std::memory_order_relaxed);
+    if (head == mCachedTail)
+    {
+        mCachedTail = mTail.load(std::memory_order_acquire);
+        if (head == mCachedTail)
+        {
+            return false;
+        }
+    }
+    item = mItems[head & (Capacity - 1)];
+    mHead.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_SPSCQUEUE_H
@@ -0,0 +1,281 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <cstring>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <boost/asio/post.hpp>
+
+#include "config.h"
+#include "error.h"
+#include "logging.h"
+#include "strategyhost.h"
+
+RTG_INLINE_GLOBAL_LOGGER_WITH_CHANNEL(LG_HOST, "HOST")
+
+namespace ReadyTraderGo {
+
+StrategyHost::StrategyHost(Application& application)
+    : mApplication(application), mContext(application.GetContext())
+{
+    mApplication.ConfigLoaded = [this](auto& tree) { ConfigLoadedHandler(tree); };
+    mApplication.ConfigReloaded = [this](auto& tree) { ConfigReloadedHandler(tree); };
+    mApplication.ReadyToRun = [this] { ReadyToRunHandler(); };
+}
+
+StrategyHost::~StrategyHost()
+{
+    StopStrategyThreads();
+}
+
+void StrategyHost::RegisterStrategy(const std::string& type, StrategyFactory factory)
+{
+    mFactories[type] = std::move(factory);
+}
+
+void StrategyHost::ConfigLoadedHandler(const boost::property_tree::ptree& tree)
+{
+    mInfoSubscriptionFactory = std::make_unique<SubscriptionFactory>(mContext,
+                                                                     tree.get<std::string>("Information.Type"),
+                                                                     tree.get<std::string>("Information.Name"));
+
+    const auto strategies = tree.get_child_optional("Strategies");
+    if (!strategies || strategies->empty())
+        throw ReadyTraderGoError("no strategies configured");
+
+    for (const auto& [name, section] : *strategies)
+    {
+        const auto type = section.get<std::string>("Type");
+        auto factory = mFactories.find(type);
+        if (factory == mFactories.end())
+            throw ReadyTraderGoError("strategy '" + name + "' has unknown type '" + type + "'");
+
+        Config config;
+        config.readTraderFromPropertyTree(section);
+
+        if (config.mTeamName.size() > MessageFieldSize::STRING)
+            throw ReadyTraderGoError("configured team name is too long");
+
+        if (config.mSecret.size() > MessageFieldSize::STRING)
+            throw ReadyTraderGoError("configured secret is too long");
+
+        auto strategy = std::make_unique<HostedStrategy>();
+        strategy->mName = name;
+        strategy->mContext = &mContext;
+        if (const auto core = section.get_optional<int>("Core"))
+        {
+            strategy->mCore = *core;
+            strategy->mOwnContext = std::make_unique<boost::asio::io_context>(1);
+            strategy->mContext = strategy->mOwnContext.get();
+            strategy->mQueue = std::make_unique<SpscQueue<FeedMessage, STRATEGY_FEED_QUEUE_SIZE>>();
+        }
+
+        strategy->mExecConnectionFactory = std::make_unique<ConnectionFactory>(*strategy->mContext,
+                                                                               config.mExecHost,
+                                                                               config.mExecPort,
+                                                                               config.mExecSocketOptions);
+        strategy->mTrader = factory->second(*strategy->mContext, section);
+        strategy->mTrader->Stopped = [this, s = strategy.get()] { RetireStrategy(*s); };
+        strategy->mTrader->SetLoginDetails(config.mTeamName, config.mSecret);
+        strategy->mTrader->LoadParameters(section);
+
+        RLOG(LG_HOST, LogLevel::LL_INFO) << "strategy '" << name << "' of type '" << type << "' for team '"
+                                         << config.mTeamName << "' runs on "
+                                         << (strategy->mQueue ? "its own thread" : "the feed thread");
+        mStrategies.push_back(std::move(strategy));
+    }
+}
+
+void StrategyHost::ConfigReloadedHandler(const boost::property_tree::ptree& tree)
+{
+    for (auto& strategy : mStrategies)
+    {
+        auto section = tree.get_child_optional("Strategies." + strategy->mName);
+        if (!section)
+        {
+            RLOG(LG_HOST, LogLevel::LL_WARNING) << "strategy '" << strategy->mName
+                                                << "' missing from reloaded configuration";
+            continue;
+        }
+
+        boost::asio::post(*strategy->mContext, [s = strategy.get(), section = *section] {
+            try
+            {
+                s->mTrader->LoadParameters(section);
+            }
+            catch (const ReadyTraderGoError& e)
+            {
+                RLOG(LG_HOST, LogLevel::LL_ERROR) << "strategy '" << s->mName << "' parameters not reloaded: "
+                                                  << e.what();
+            }
+        });
+    }
+}
+
+void StrategyHost::ReadyToRunHandler()
+{
+    for (auto& strategy : mStrategies)
+    {
+        strategy->mTrader->SetExecutionConnectionFactory(strategy->mExecConnectionFactory.get());
+        strategy->mTrader->SetExecutionConnection(strategy->mExecConnectionFactory->Create());
+        if (strategy->mQueue)
+        {
+            PollQueue(*strategy);
+            strategy->mThread = std::thread([this, s = strategy.get()] { RunStrategyThread(*s); });
+        }
+    }
+
+    mInfoSubscription = mInfoSubscriptionFactory->Create();
+    mInfoSubscription->SetName("Info");
+    mInfoSubscription->MessageReceived = [this](ISubscription* s,
+                                                unsigned char t,
+                                                unsigned char const* d,
+                                                std::size_t z) { MessageHandler(s, t, d, z); };
+    mInfoSubscription->AsyncReceive();
+}
+
+void StrategyHost::MessageHandler(ISubscription*,
+                                  unsigned char messageType,
+                                  unsigned char const* data,
+                                  std::size_t size)
+{
+    switch (messageType)
+    {
+    case MessageType::ORDER_BOOK_UPDATE:
+        Publish(makeMessage<OrderBookMessage>(data, size));
+        break;
+    case MessageType::TRADE_TICKS:
+        Publish(makeMessage<TradeTicksMessage>(data, size));
+        break;
+    default:
+        RLOG(LG_HOST, LogLevel::LL_ERROR) << "received information message with unexpected type: "
+                                          << static_cast<int>(messageType);
+        throw ReadyTraderGoError("received information message with unexpected type");
+    }
+}
+
+void StrategyHost::Publish(const FeedMessage& message)
+{
+    for (auto& strategy : mStrategies)
+    {
+        if (strategy->mRetired.load(std::memory_order_relaxed))
+        {
+            continue;
+        }
+        if (!strategy->mQueue)
+        {
+            Deliver(*strategy->mTrader, message);
+        }
+        else if (!strategy->mQueue->TryPush(message) && (strategy->mDropped++ & 1023) == 0)
+        {
+            RLOG(LG_HOST, LogLevel::LL_WARNING) << "strategy '" << strategy->mName
+                                                << "' is not keeping up, dropped "
+                                                << strategy->mDropped << " information message(s)";
+        }
+    }
+}
+
+void StrategyHost::Deliver(BaseAutoTrader& trader, const FeedMessage& message)
+{
+    if (const auto* book = std::get_if<OrderBookMessage>(&message))
+        trader.DeliverOrderBook(*book);
+    else
+        trader.DeliverTradeTicks(std::get<TradeTicksMessage>(message));
+}
+
+// Runs on the strategy's own thread: drain its queue, then check again on
+// the next turn of its event loop, as the information subscription does.
+void StrategyHost::PollQueue(HostedStrategy& strategy)
+{
+    FeedMessage message;
+    while (strategy.mQueue->TryPop(message))
+    {
+        Deliver(*strategy.mTrader, message);
+    }
+    boost::asio::post(*strategy.mContext, makeAllocatingHandler(strategy.mHandlerMemory,
+                                                                [this, &strategy] { PollQueue(strategy); }));
+}
+
+void StrategyHost::RunStrategyThread(HostedStrategy& strategy)
+{
+#ifdef __linux__
+    if (strategy.mCore >= 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(strategy.mCore, &cpus);
+        if (int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus); err != 0)
+        {
+            RLOG(LG_HOST, LogLevel::LL_WARNING) << "strategy '" << strategy.mName << "' could not be pinned to core "
+                                                << strategy.mCore << ": " << std::strerror(err);
+        }
+    }
+#else
+    if (strategy.mCore >= 0)
+    {
+        RLOG(LG_HOST, LogLevel::LL_WARNING) << "strategy '" << strategy.mName
+                                            << "' not pinned: thread affinity is not supported on this platform";
+    }
+#endif
+
+    try
+    {
+        strategy.mContext->run();
+    }
+    catch (const ReadyTraderGoError& e)
+    {
+        RLOG(LG_HOST, LogLevel::LL_ERROR) << "strategy '" << strategy.mName << "' stopped: " << e.what();
+    }
+    RLOG(LG_HOST, LogLevel::LL_INFO) << "strategy '" << strategy.mName << "' thread finished";
+}
+
+// Runs on the strategy's event loop. Only a strategy with a context of its
+// own may stop it; the shared one keeps running the feed for the others.
+void StrategyHost::RetireStrategy(HostedStrategy& strategy)
+{
+    if (strategy.mRetired.exchange(true))
+        return;
+
+    RLOG(LG_HOST, LogLevel::LL_ERROR) << "strategy '" << strategy.mName << "' stopped";
+    if (strategy.mOwnContext)
+        strategy.mOwnContext->stop();
+
+    if (++mRetiredCount == mStrategies.size())
+    {
+        RLOG(LG_HOST, LogLevel::LL_ERROR) << "every strategy has stopped";
+        mContext.stop();
+    }
+}
+
+void StrategyHost::StopStrategyThreads()
+{
+    for (auto& strategy : mStrategies)
+    {
+        if (strategy->mThread.joinable())
+        {
+            strategy->mOwnContext->stop();
+            strategy->mThread.join();
+        }
+    }
+}
+
+}
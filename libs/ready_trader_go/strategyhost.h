@@ -0,0 +1,128 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_STRATEGYHOST_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_STRATEGYHOST_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include "application.h"
+#include "baseautotrader.h"
+#include "connectivity.h"
+#include "handlerallocator.h"
+#include "protocol.h"
+#include "spscqueue.h"
+
+namespace ReadyTraderGo {
+
+// Number of decoded information messages that may be waiting for a trader
+// running on its own thread before further messages are dropped.
+constexpr std::size_t STRATEGY_FEED_QUEUE_SIZE = 1024;
+
+// Runs several traders in one process on one information feed.
+//
+// The configuration has the usual "Information" section and a "Strategies"
+// section with one sub-section per trader. Each of those gives the trader's
+// "Type" (as registered with RegisterStrategy), its own "Execution",
+// "TeamName" and "Secret" and, optionally, a "Core". Traders without a core
+// run on the application's thread; the others get a thread of their own,
+// pinned to the given core unless it is -1.
+//
+// The information feed is read and every message decoded once, on the
+// application's thread, and the decoded message is then handed to each
+// trader either directly or through that trader's queue.
+//
+// When the configuration is reloaded each trader is given its new section,
+// on the trader's own thread. Traders cannot be added or removed this way.
+//
+// A trader that stops (see BaseAutoTrader::Stopped) is retired on its own:
+// it is given no further information messages and its thread, if it has
+// one, finishes. The host stops once every trader has.
+class StrategyHost
+{
+public:
+    using StrategyFactory = std::function<std::unique_ptr<BaseAutoTrader>(boost::asio::io_context&,
+                                                                          const boost::property_tree::ptree&)>;
+
+    explicit StrategyHost(Application& application);
+    ~StrategyHost();
+
+    StrategyHost(const StrategyHost&) = delete;
+    void operator=(const StrategyHost&) = delete;
+
+    // Make a type of trader available to the "Type" configuration setting.
+    // The factory is given the trader's event loop and its configuration
+    // section.
+    void RegisterStrategy(const std::string& type, StrategyFactory factory);
+
+private:
+    using FeedMessage = std::variant<OrderBookMessage, TradeTicksMessage>;
+
+    struct HostedStrategy
+    {
+        std::string mName;
+        int mCore = -1;
+        std::unique_ptr<boost::asio::io_context> mOwnContext;
+        boost::asio::io_context* mContext = nullptr;
+        std::unique_ptr<ConnectionFactory> mExecConnectionFactory;
+        std::unique_ptr<BaseAutoTrader> mTrader;
+        std::unique_ptr<SpscQueue<FeedMessage, STRATEGY_FEED_QUEUE_SIZE>> mQueue;
+        HandlerMemory mHandlerMemory;
+        std::thread mThread;
+        std::size_t mDropped = 0;
+        std::atomic<bool> mRetired = false;
+    };
+
+    void ConfigLoadedHandler(const boost::property_tree::ptree& tree);
+    void ConfigReloadedHandler(const boost::property_tree::ptree& tree);
+    void ReadyToRunHandler();
+    void MessageHandler(ISubscription* subscription,
+                        unsigned char messageType,
+                        unsigned char const* data,
+                        std::size_t size);
+    void Publish(const FeedMessage& message);
+    void PollQueue(HostedStrategy& strategy);
+    void RunStrategyThread(HostedStrategy& strategy);
+    void RetireStrategy(HostedStrategy& strategy);
+    void StopStrategyThreads();
+
+    static void Deliver(BaseAutoTrader& trader, const FeedMessage& message);
+
+    Application& mApplication;
+    boost::asio::io_context& mContext;
+
+    std::map<std::string, StrategyFactory> mFactories;
+    std::unique_ptr<SubscriptionFactory> mInfoSubscriptionFactory;
+    std::shared_ptr<ISubscription> mInfoSubscription;
+    std::vector<std::unique_ptr<HostedStrategy>> mStrategies;
+    std::atomic<std::size_t> mRetiredCount = 0;
+};
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_STRATEGYHOST_H
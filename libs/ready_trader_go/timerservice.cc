@@ -0,0 +1,125 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+
+#include <boost/asio/error.hpp>
+#include <boost/asio/post.hpp>
+
+#include "timerservice.h"
+
+namespace ReadyTraderGo {
+
+TimerService::TimerService(boost::asio::io_context& context, Clock::duration resolution)
+    : mContext(context), mWheel(resolution), mTimer(context)
+{
+}
+
+void TimerService::Schedule(WheelTimer& timer, Clock::time_point when)
+{
+    mWheel.Schedule(timer, when);
+    Arm();
+}
+
+void TimerService::SetBusyPollMode(bool busyPollMode)
+{
+    if (busyPollMode == mBusyPollMode)
+        return;
+
+    mBusyPollMode = busyPollMode;
+    if (mBusyPollMode)
+    {
+        mTimer.cancel();
+        mArmedFor = Clock::time_point::max();
+    }
+    Arm();
+}
+
+void TimerService::AdvanceTo(Clock::time_point now)
+{
+    if (!mIsManual)
+    {
+        mIsManual = true;
+        mTimer.cancel();
+        mArmedFor = Clock::time_point::max();
+    }
+    mManualNow = std::max(mManualNow, now);
+    mWheel.Advance(mManualNow);
+}
+
+// Only ever brings the steady_timer forward: a timer that went off early
+// finds nothing due and re-arms itself.
+void TimerService::Arm()
+{
+    if (mWheel.IsEmpty() || mIsManual)
+        return;
+
+    if (mBusyPollMode)
+    {
+        if (!mIsPolling)
+        {
+            mIsPolling = true;
+            boost::asio::post(mContext, makeAllocatingHandler(mPollHandlerMemory, [this] { Poll(); }));
+        }
+        return;
+    }
+
+    const auto next = mWheel.NextTick();
+    if (next >= mArmedFor)
+        return;
+
+    // If the wait in progress has already completed, its handler will run
+    // shortly and find the earlier timer due
+    const bool isWaiting = mArmedFor != Clock::time_point::max();
+    mArmedFor = next;
+    if (mTimer.expires_after(std::max(next - Clock::now(), Clock::duration::zero())) == 0 && isWaiting)
+        return;
+    mTimer.async_wait(makeAllocatingHandler(mTimerHandlerMemory,
+                                            [this](auto& error) { TimerHandler(error); }));
+}
+
+void TimerService::Poll()
+{
+    if (mIsManual)
+    {
+        mIsPolling = false;
+        return;
+    }
+    mWheel.Advance(Clock::now());
+    if (!mBusyPollMode || mWheel.IsEmpty())
+    {
+        mIsPolling = false;
+        Arm();
+        return;
+    }
+    boost::asio::post(mContext, makeAllocatingHandler(mPollHandlerMemory, [this] { Poll(); }));
+}
+
+// The coarse clock may lag the steady clock by a few milliseconds, but the
+// time the steady_timer was armed for has certainly passed.
+void TimerService::TimerHandler(const boost::system::error_code& error)
+{
+    if (error == boost::asio::error::operation_aborted || mArmedFor == Clock::time_point::max() || mIsManual)
+        return;
+
+    const auto armedFor = mArmedFor;
+    mArmedFor = Clock::time_point::max();
+    mWheel.Advance(std::max(Clock::now(), armedFor));
+    Arm();
+}
+
+}
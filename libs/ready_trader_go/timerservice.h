@@ -0,0 +1,91 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_TIMERSERVICE_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_TIMERSERVICE_H
+
+#include <chrono>
+#include <cstddef>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/system/error_code.hpp>
+
+#include "handlerallocator.h"
+#include "timerwheel.h"
+
+namespace ReadyTraderGo {
+
+// Runs a TimerWheel from the trader's event loop, so that timers fire between
+// the trader's other handlers. Normally a single steady_timer is kept armed
+// for the wheel's next tick. In busy-poll mode, where the event loop never
+// sleeps, the wheel is instead advanced by a handler that re-posts itself
+// while any timer is scheduled, in turn with the execution socket reads.
+//
+// Once AdvanceTo has been called the service no longer reads the clock or
+// waits on the event loop: time stands still between calls, so that a
+// backtest can run the timers in simulated time.
+class TimerService
+{
+public:
+    using Clock = TimerWheel::Clock;
+
+    explicit TimerService(boost::asio::io_context& context,
+                          Clock::duration resolution = std::chrono::milliseconds(1));
+
+    TimerService(const TimerService&) = delete;
+    void operator=(const TimerService&) = delete;
+
+    void Schedule(WheelTimer& timer, Clock::time_point when);
+    void ScheduleAfter(WheelTimer& timer, Clock::duration delay) { Schedule(timer, Now() + delay); }
+    void Cancel(WheelTimer& timer) noexcept { mWheel.Cancel(timer); }
+
+    // The time on the timers' clock: Clock::now(), or the time last given
+    // to AdvanceTo.
+    Clock::time_point Now() const noexcept { return mIsManual ? mManualNow : Clock::now(); }
+
+    // Set the time, which must not go backwards, and fire every timer due
+    // by then.
+    void AdvanceTo(Clock::time_point now);
+    bool IsManual() const noexcept { return mIsManual; }
+
+    bool IsBusyPollMode() const noexcept { return mBusyPollMode; }
+    void SetBusyPollMode(bool busyPollMode);
+
+    const TimerWheel& GetWheel() const noexcept { return mWheel; }
+
+private:
+    void Arm();
+    void Poll();
+    void TimerHandler(const boost::system::error_code& error);
+
+    boost::asio::io_context& mContext;
+    TimerWheel mWheel;
+    boost::asio::steady_timer mTimer;
+    // When the steady_timer is due, on the wheel's clock
+    Clock::time_point mArmedFor = Clock::time_point::max();
+    HandlerMemory mTimerHandlerMemory;
+    HandlerMemory mPollHandlerMemory;
+    bool mBusyPollMode = false;
+    bool mIsPolling = false;
+    bool mIsManual = false;
+    Clock::time_point mManualNow;
+};
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_TIMERSERVICE_H
@@ -0,0 +1,201 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include "timerwheel.h"
+
+namespace ReadyTraderGo {
+
+TimerWheel::TimerWheel(Clock::duration resolution, Clock::time_point start) noexcept
+    : mResolution(resolution > Clock::duration::zero() ? resolution : Clock::duration(1)), mStart(start)
+{
+}
+
+TimerWheel::~TimerWheel()
+{
+    for (auto& level : mSlots)
+    {
+        for (auto& slot : level)
+        {
+            for (auto* timer = slot.mFirst; timer != nullptr; timer = timer->mNext)
+                timer->mWheel = nullptr;
+        }
+    }
+}
+
+// Timers never fire early, so their expiry is rounded up to a whole tick.
+std::uint64_t TimerWheel::TickOf(Clock::time_point when) const noexcept
+{
+    if (when <= mStart)
+        return 0;
+    const auto elapsed = (when - mStart).count();
+    const auto resolution = mResolution.count();
+    return static_cast<std::uint64_t>((elapsed + resolution - 1) / resolution);
+}
+
+TimerWheel::Clock::time_point TimerWheel::TimeOf(std::uint64_t tick) const noexcept
+{
+    return mStart + mResolution * static_cast<Clock::rep>(tick);
+}
+
+void TimerWheel::Schedule(WheelTimer& timer, Clock::time_point when) noexcept
+{
+    if (timer.mWheel != nullptr)
+        timer.mWheel->Unlink(timer);
+
+    const std::uint64_t tick = TickOf(when);
+    timer.mExpiryTick = tick > mCurrentTick ? tick : mCurrentTick + 1;
+    timer.mWheel = this;
+    ++mCount;
+    Place(timer);
+}
+
+// A timer goes in the level of the highest digit in which its expiry differs
+// from the current tick, in the slot for its expiry's digit at that level, so
+// that it is reached when that digit next changes. A timer beyond the top
+// level goes in the top level slot reached last, and is placed again from
+// there.
+void TimerWheel::Place(WheelTimer& timer) noexcept
+{
+    const std::uint64_t difference = timer.mExpiryTick ^ mCurrentTick;
+    std::size_t level = 0;
+    std::size_t slotIndex;
+    if (difference > MAX_TICKS)
+    {
+        // In a later revolution of the top level: the slot for the expiry if
+        // that is reached first, otherwise the slot reached last
+        level = LEVEL_COUNT - 1;
+        const unsigned shift = SLOT_BITS * (LEVEL_COUNT - 1);
+        const std::uint64_t digit = (mCurrentTick >> shift) & SLOT_MASK;
+        const std::uint64_t expiryDigit = (timer.mExpiryTick >> shift) & SLOT_MASK;
+        const bool isNextRevolution = (timer.mExpiryTick >> (shift + SLOT_BITS)) == (mCurrentTick >> (shift + SLOT_BITS)) + 1;
+        slotIndex = static_cast<std::size_t>(isNextRevolution && expiryDigit < digit ? expiryDigit : (digit + SLOT_MASK) & SLOT_MASK);
+    }
+    else
+    {
+        while (level < LEVEL_COUNT - 1 && (difference >> (SLOT_BITS * (level + 1))) != 0)
+            ++level;
+        slotIndex = static_cast<std::size_t>((timer.mExpiryTick >> (SLOT_BITS * level)) & SLOT_MASK);
+    }
+
+    Slot& slot = mSlots[level][slotIndex];
+    timer.mLevel = static_cast<unsigned char>(level);
+    timer.mSlot = static_cast<unsigned char>(slotIndex);
+    timer.mPrevious = nullptr;
+    timer.mNext = slot.mFirst;
+    if (slot.mFirst != nullptr)
+        slot.mFirst->mPrevious = &timer;
+    slot.mFirst = &timer;
+    mOccupied[level] |= std::uint64_t(1) << slotIndex;
+}
+
+void TimerWheel::Unlink(WheelTimer& timer) noexcept
+{
+    Slot& slot = mSlots[timer.mLevel][timer.mSlot];
+    if (timer.mPrevious != nullptr)
+        timer.mPrevious->mNext = timer.mNext;
+    else
+        slot.mFirst = timer.mNext;
+    if (timer.mNext != nullptr)
+        timer.mNext->mPrevious = timer.mPrevious;
+    if (slot.mFirst == nullptr)
+        mOccupied[timer.mLevel] &= ~(std::uint64_t(1) << timer.mSlot);
+
+    timer.mPrevious = timer.mNext = nullptr;
+    timer.mWheel = nullptr;
+    --mCount;
+}
+
+// Move the timers in a level's current slot down to the levels below (or into
+// the current level 0 slot, if they are due now).
+void TimerWheel::Cascade(std::size_t level) noexcept
+{
+    const auto slotIndex = static_cast<std::size_t>((mCurrentTick >> (SLOT_BITS * level)) & SLOT_MASK);
+    Slot& slot = mSlots[level][slotIndex];
+    WheelTimer* timer = slot.mFirst;
+    slot.mFirst = nullptr;
+    mOccupied[level] &= ~(std::uint64_t(1) << slotIndex);
+    while (timer != nullptr)
+    {
+        WheelTimer* next = timer->mNext;
+        Place(*timer);
+        timer = next;
+    }
+}
+
+// The first tick after the current one at which some slot is reached. Every
+// occupied slot is ahead of the current tick's digit at its level, except
+// that top level slots behind it are reached in the next revolution, so this
+// is the next occupied slot of the lowest level that has one.
+static std::uint64_t nextOccupiedTick(std::uint64_t currentTick,
+                                      const std::array<std::uint64_t, TimerWheel::LEVEL_COUNT>& occupied) noexcept
+{
+    constexpr std::size_t top = TimerWheel::LEVEL_COUNT - 1;
+    for (std::size_t level = 0; level <= top; ++level)
+    {
+        const unsigned shift = TimerWheel::SLOT_BITS * static_cast<unsigned>(level);
+        const std::uint64_t span = std::uint64_t(1) << (shift + TimerWheel::SLOT_BITS);
+        const std::uint64_t base = currentTick & ~(span - 1);
+        const auto digit = static_cast<unsigned>((currentTick >> shift) & TimerWheel::SLOT_MASK);
+        const std::uint64_t ahead = digit == TimerWheel::SLOT_MASK
+                                    ? 0 : occupied[level] & (~std::uint64_t(0) << (digit + 1));
+        if (ahead != 0)
+            return base + (static_cast<std::uint64_t>(__builtin_ctzll(ahead)) << shift);
+        if (level == top && occupied[level] != 0)
+            return base + span + (static_cast<std::uint64_t>(__builtin_ctzll(occupied[level])) << shift);
+    }
+    return ~std::uint64_t(0);
+}
+
+TimerWheel::Clock::time_point TimerWheel::NextTick() const noexcept
+{
+    const std::uint64_t tick = nextOccupiedTick(mCurrentTick, mOccupied);
+    return tick == ~std::uint64_t(0) ? Clock::time_point::max() : TimeOf(tick);
+}
+
+std::size_t TimerWheel::Advance(Clock::time_point now)
+{
+    const std::uint64_t target = now <= mStart ? 0 : static_cast<std::uint64_t>((now - mStart) / mResolution);
+    std::size_t fired = 0;
+
+    while (mCount != 0 && mCurrentTick < target)
+    {
+        const std::uint64_t next = nextOccupiedTick(mCurrentTick, mOccupied);
+        if (next > target)
+            break;
+        mCurrentTick = next;
+
+        for (std::size_t level = LEVEL_COUNT - 1; level > 0; --level)
+        {
+            if ((mCurrentTick & ((std::uint64_t(1) << (SLOT_BITS * level)) - 1)) == 0)
+                Cascade(level);
+        }
+
+        Slot& slot = mSlots[0][mCurrentTick & SLOT_MASK];
+        while (WheelTimer* timer = slot.mFirst)
+        {
+            Unlink(*timer);
+            ++fired;
+            timer->mFunction(timer->mObject);
+        }
+    }
+
+    if (mCurrentTick < target)
+        mCurrentTick = target;
+    return fired;
+}
+
+}
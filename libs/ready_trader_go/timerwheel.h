@@ -0,0 +1,189 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_TIMERWHEEL_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_TIMERWHEEL_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <time.h>
+#endif
+
+namespace ReadyTraderGo {
+
+// A monotonic clock that is cheap enough to read on every event. On Linux it
+// is CLOCK_MONOTONIC_COARSE, which is read without a system call and moves
+// in steps of the kernel's tick (a few milliseconds); elsewhere it is
+// std::chrono::steady_clock.
+struct CoarseClock
+{
+    using duration = std::chrono::nanoseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<CoarseClock>;
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept
+    {
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return time_point(duration(static_cast<rep>(ts.tv_sec) * 1000000000 + ts.tv_nsec));
+#else
+        return time_point(std::chrono::duration_cast<duration>(
+            std::chrono::steady_clock::now().time_since_epoch()));
+#endif
+    }
+};
+
+class TimerWheel;
+
+// Something to be done at a given time. A timer belongs to whoever declares
+// it (typically as a member of the object whose method it calls) and holds
+// everything the wheel needs, so scheduling and cancelling never allocate.
+// A timer is cancelled when it is destroyed.
+class WheelTimer
+{
+public:
+    using Function = void (*)(void*);
+
+    WheelTimer(Function function, void* object) noexcept : mFunction(function), mObject(object) {}
+    ~WheelTimer();
+
+    WheelTimer(const WheelTimer&) = delete;
+    void operator=(const WheelTimer&) = delete;
+
+    // A timer that calls object->*Method().
+    template<auto Method, typename T>
+    static WheelTimer Calling(T* object) noexcept
+    {
+        return WheelTimer([](void* o) { (static_cast<T*>(o)->*Method)(); }, object);
+    }
+
+    bool IsScheduled() const noexcept { return mWheel != nullptr; }
+
+private:
+    friend class TimerWheel;
+
+    Function mFunction;
+    void* mObject;
+
+    // Links in the wheel's slot list, while scheduled
+    WheelTimer* mPrevious = nullptr;
+    WheelTimer* mNext = nullptr;
+    TimerWheel* mWheel = nullptr;
+    std::uint64_t mExpiryTick = 0;
+    unsigned char mLevel = 0;
+    unsigned char mSlot = 0;
+};
+
+// A hierarchical hashed timer wheel: four levels of 64 slots, each level's
+// slot spanning the whole of the level below. Scheduling and cancelling are
+// O(1); advancing costs one step per tick elapsed (none while the wheel is
+// empty) plus, every 64 ticks, moving the next level's due slot down.
+// Timers due in the same tick fire in no particular order.
+//
+// The wheel does not read a clock itself. Whoever drives it (see
+// TimerService) calls Advance with the time, and NextTick tells it how long
+// it may wait before doing so.
+class TimerWheel
+{
+public:
+    static constexpr unsigned SLOT_BITS = 6;
+    static constexpr std::size_t SLOT_COUNT = std::size_t(1) << SLOT_BITS;
+    static constexpr std::size_t LEVEL_COUNT = 4;
+    static constexpr std::uint64_t SLOT_MASK = SLOT_COUNT - 1;
+    // Timers further away than this many ticks wait in the top level and
+    // are placed again when it comes round
+    static constexpr std::uint64_t MAX_TICKS = (std::uint64_t(1) << (SLOT_BITS * LEVEL_COUNT)) - 1;
+
+    using Clock = CoarseClock;
+
+    // Ticks are 'resolution' long; timers fire up to one tick late.
+    explicit TimerWheel(Clock::duration resolution = std::chrono::milliseconds(1),
+                        Clock::time_point start = Clock::now()) noexcept;
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel&) = delete;
+    void operator=(const TimerWheel&) = delete;
+
+    // Schedule (or reschedule) a timer, either at a given time or after a
+    // delay from the time last advanced to. A time already passed fires on
+    // the next tick.
+    void Schedule(WheelTimer& timer, Clock::time_point when) noexcept;
+    void ScheduleAfter(WheelTimer& timer, Clock::duration delay) noexcept;
+    void Cancel(WheelTimer& timer) noexcept;
+
+    // Fire every timer due by 'now'. Timers may schedule or cancel timers,
+    // themselves included, when they fire. Returns the number fired.
+    std::size_t Advance(Clock::time_point now);
+
+    std::size_t GetCount() const noexcept { return mCount; }
+    bool IsEmpty() const noexcept { return mCount == 0; }
+
+    // The time by which Advance next needs to be called: the next occupied
+    // slot, or the next time a higher level must be moved down. Only
+    // meaningful if the wheel is not empty.
+    Clock::time_point NextTick() const noexcept;
+
+    Clock::duration GetResolution() const noexcept { return mResolution; }
+
+private:
+    struct Slot
+    {
+        WheelTimer* mFirst = nullptr;
+    };
+
+    std::uint64_t TickOf(Clock::time_point when) const noexcept;
+    Clock::time_point TimeOf(std::uint64_t tick) const noexcept;
+    void Place(WheelTimer& timer) noexcept;
+    void Unlink(WheelTimer& timer) noexcept;
+    void Cascade(std::size_t level) noexcept;
+
+    Clock::duration mResolution;
+    Clock::time_point mStart;
+    std::uint64_t mCurrentTick = 0;
+    std::size_t mCount = 0;
+    std::array<std::array<Slot, SLOT_COUNT>, LEVEL_COUNT> mSlots{};
+    // Bit i of mOccupied[level] is set if that level's slot i has timers
+    std::array<std::uint64_t, LEVEL_COUNT> mOccupied{};
+};
+
+inline WheelTimer::~WheelTimer()
+{
+    if (mWheel)
+        mWheel->Cancel(*this);
+}
+
+inline void TimerWheel::ScheduleAfter(WheelTimer& timer, Clock::duration delay) noexcept
+{
+    Schedule(timer, TimeOf(mCurrentTick) + delay);
+}
+
+inline void TimerWheel::Cancel(WheelTimer& timer) noexcept
+{
+    if (timer.mWheel == this)
+        Unlink(timer);
+}
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_TIMERWHEEL_H
@@ -0,0 +1,94 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_UNHEDGEDLOTS_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_UNHEDGEDLOTS_H
+
+namespace ReadyTraderGo {
+
+// From ready_trader_go/unhedged_lots.py
+constexpr long MAX_UNHEDGED_LOTS = 10;
+constexpr double UNHEDGED_LOTS_TIME_LIMIT = 60.0;
+
+// The exchange's rule on unhedged lots: once the ETF and future positions
+// together differ from zero by more than MAX_UNHEDGED_LOTS, they must come
+// back within that many lots before UNHEDGED_LOTS_TIME_LIMIT seconds have
+// passed. This keeps the same relative position and deadline as the
+// exchange, given the time of each position change; the caller decides what
+// to do when the deadline arrives.
+class UnhedgedLots
+{
+public:
+    // Apply a change in the ETF or future position (positive for a buy).
+    void ApplyPositionDelta(double now, long delta) noexcept;
+
+    long GetRelativePosition() const noexcept { return mRelativePosition; }
+    // Lots held beyond MAX_UNHEDGED_LOTS, with the sign of the position.
+    long GetUnhedgedLotCount() const noexcept;
+
+    bool HasDeadline() const noexcept { return mHasDeadline; }
+    // Valid only if HasDeadline()
+    double GetDeadline() const noexcept { return mDeadline; }
+    void ClearDeadline() noexcept { mHasDeadline = false; }
+
+private:
+    long mRelativePosition = 0;
+    bool mHasDeadline = false;
+    double mDeadline = 0.0;
+};
+
+inline void UnhedgedLots::ApplyPositionDelta(double now, long delta) noexcept
+{
+    const long position = mRelativePosition;
+    const long next = position + delta;
+
+    if (delta > 0)
+    {
+        if (position < -MAX_UNHEDGED_LOTS && -MAX_UNHEDGED_LOTS <= next)
+            mHasDeadline = false;
+        if (next > MAX_UNHEDGED_LOTS && MAX_UNHEDGED_LOTS >= position)
+        {
+            mHasDeadline = true;
+            mDeadline = now + UNHEDGED_LOTS_TIME_LIMIT;
+        }
+    }
+    else if (delta < 0)
+    {
+        if (position > MAX_UNHEDGED_LOTS && MAX_UNHEDGED_LOTS >= next)
+            mHasDeadline = false;
+        if (next < -MAX_UNHEDGED_LOTS && -MAX_UNHEDGED_LOTS <= position)
+        {
+            mHasDeadline = true;
+            mDeadline = now + UNHEDGED_LOTS_TIME_LIMIT;
+        }
+    }
+
+    mRelativePosition = next;
+}
+
+inline long UnhedgedLots::GetUnhedgedLotCount() const noexcept
+{
+    if (mRelativePosition > MAX_UNHEDGED_LOTS)
+        return mRelativePosition - MAX_UNHEDGED_LOTS;
+    if (mRelativePosition < -MAX_UNHEDGED_LOTS)
+        return mRelativePosition + MAX_UNHEDGED_LOTS;
+    return 0;
+}
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_UNHEDGEDLOTS_H
@@ -0,0 +1,196 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_WIRESCHEMA_H
+#define CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_WIRESCHEMA_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <boost/endian/conversion.hpp>
+
+#include "connectivitytypes.h"
+#include "fixedstring.h"
+
+namespace ReadyTraderGo {
+
+template<typename>
+struct MemberTraits;
+
+template<typename C, typename T>
+struct MemberTraits<T C::*>
+{
+    using Class = C;
+    using Type = T;
+};
+
+// Field encodings. Each names a message member and describes how it is laid
+// out on the wire.
+
+// An integer member sent as a four-byte, big endian integer (signed if the
+// member is signed).
+template<auto Member>
+struct WireLong
+{
+    using Class = typename MemberTraits<decltype(Member)>::Class;
+    using Type = typename MemberTraits<decltype(Member)>::Type;
+    using WireType = std::conditional_t<std::is_signed_v<Type>, int32_t, uint32_t>;
+    static constexpr std::size_t SIZE = sizeof(WireType);
+
+    static void Write(const Class& message, unsigned char* buf) noexcept
+    {
+        boost::endian::store_big_u32(buf, static_cast<uint32_t>(static_cast<WireType>(message.*Member)));
+    }
+
+    static void Read(Class& message, unsigned char const* data) noexcept
+    {
+        message.*Member = static_cast<Type>(static_cast<WireType>(boost::endian::load_big_u32(data)));
+    }
+};
+
+// An enumeration (or other one-byte value) member sent as a single byte.
+template<auto Member>
+struct WireByte
+{
+    using Class = typename MemberTraits<decltype(Member)>::Class;
+    using Type = typename MemberTraits<decltype(Member)>::Type;
+    static constexpr std::size_t SIZE = 1;
+
+    static void Write(const Class& message, unsigned char* buf) noexcept
+    {
+        *buf = static_cast<unsigned char>(message.*Member);
+    }
+
+    static void Read(Class& message, unsigned char const* data) noexcept
+    {
+        message.*Member = Type(*data);
+    }
+};
+
+// A FixedString member sent as its zero-padded characters.
+template<auto Member>
+struct WireString
+{
+    using Class = typename MemberTraits<decltype(Member)>::Class;
+    using Type = typename MemberTraits<decltype(Member)>::Type;
+    static constexpr std::size_t SIZE = Type::Capacity();
+
+    static void Write(const Class& message, unsigned char* buf) noexcept { (message.*Member).Write(buf); }
+    static void Read(Class& message, unsigned char const* data) noexcept { (message.*Member).Read(data); }
+};
+
+// A std::array member sent as consecutive four-byte, big endian integers.
+template<auto Member>
+struct WireLongArray
+{
+    using Class = typename MemberTraits<decltype(Member)>::Class;
+    using Type = typename MemberTraits<decltype(Member)>::Type;
+    static constexpr std::size_t COUNT = std::tuple_size<Type>::value;
+    static constexpr std::size_t SIZE = COUNT * sizeof(uint32_t);
+
+    static void Write(const Class& message, unsigned char* buf) noexcept
+    {
+        for (std::size_t i = 0; i < COUNT; ++i)
+        {
+            boost::endian::store_big_u32(buf + i * sizeof(uint32_t), static_cast<uint32_t>((message.*Member)[i]));
+        }
+    }
+
+    static void Read(Class& message, unsigned char const* data) noexcept
+    {
+        for (std::size_t i = 0; i < COUNT; ++i)
+        {
+            (message.*Member)[i] = boost::endian::load_big_u32(data + i * sizeof(uint32_t));
+        }
+    }
+};
+
+// The wire layout of a message: its fields, in order, with no padding. The
+// size and field offsets are computed at compile time and the encode and
+// decode routines are expanded inline, one store or load per field.
+template<typename... Fields>
+struct WireSchema
+{
+    static constexpr std::size_t FIELD_COUNT = sizeof...(Fields);
+    static constexpr std::size_t SIZE = (Fields::SIZE + ... + 0);
+
+    template<std::size_t I>
+    static constexpr std::size_t Offset() noexcept { return OFFSETS[I]; }
+
+    template<typename Message>
+    static void Serialise(const Message& message, unsigned char* buf) noexcept
+    {
+        Serialise(message, buf, std::index_sequence_for<Fields...>());
+    }
+
+    template<typename Message>
+    static void Deserialise(Message& message, unsigned char const* data) noexcept
+    {
+        Deserialise(message, data, std::index_sequence_for<Fields...>());
+    }
+
+private:
+    static constexpr std::array<std::size_t, FIELD_COUNT> ComputeOffsets() noexcept
+    {
+        std::array<std::size_t, FIELD_COUNT> offsets = {};
+        std::size_t offset = 0;
+        std::size_t i = 0;
+        ((offsets[i++] = offset, offset += Fields::SIZE), ...);
+        return offsets;
+    }
+
+    static constexpr std::array<std::size_t, FIELD_COUNT> OFFSETS = ComputeOffsets();
+
+    template<typename Message, std::size_t... I>
+    static void Serialise(const Message& message, unsigned char* buf, std::index_sequence<I...>) noexcept
+    {
+        (Fields::Write(message, buf + OFFSETS[I]), ...);
+    }
+
+    template<typename Message, std::size_t... I>
+    static void Deserialise(Message& message, unsigned char const* data, std::index_sequence<I...>) noexcept
+    {
+        (Fields::Read(message, data + OFFSETS[I]), ...);
+    }
+};
+
+// Implements ISerialisable for a message type M from its M::Schema, so that
+// messages can still be handled generically. Code that knows the message
+// type should use M::Schema directly and avoid the virtual calls.
+template<typename M>
+struct WireMessage : ISerialisable
+{
+    std::size_t Size() const noexcept override { return M::Schema::SIZE; }
+
+    void Deserialise(unsigned char const* data, std::size_t) override
+    {
+        M::Schema::Deserialise(static_cast<M&>(*this), data);
+    }
+
+    void Serialise(unsigned char* buf) const override
+    {
+        M::Schema::Serialise(static_cast<const M&>(*this), buf);
+    }
+};
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_READY_TRADER_GO_WIRESCHEMA_H
@@ -0,0 +1,65 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+#include <cmath>
+
+#include "account.h"
+
+namespace ReadyTraderGo {
+
+Account::Account(double etfClamp, unsigned long tickSize)
+    : mEtfClamp(etfClamp), mTickSize(static_cast<long>(tickSize))
+{
+}
+
+void Account::Transact(Instrument instrument, Side side, unsigned long price, unsigned long volume, long fee)
+{
+    const long value = static_cast<long>(price * volume);
+    const long signedVolume = side == Side::BUY ? static_cast<long>(volume) : -static_cast<long>(volume);
+
+    mAccountBalance += side == Side::SELL ? value : -value;
+    mAccountBalance -= fee;
+    mTotalFees += fee;
+
+    if (instrument == Instrument::FUTURE)
+    {
+        mFuturePosition += signedVolume;
+        return;
+    }
+
+    mEtfPosition += signedVolume;
+    if (side == Side::BUY)
+        mBuyVolume += volume;
+    else
+        mSellVolume += volume;
+}
+
+void Account::Update(unsigned long futurePrice, unsigned long etfPrice)
+{
+    const long future = static_cast<long>(futurePrice);
+    // Rounded half to even, as Python's round() does
+    long delta = static_cast<long>(std::nearbyint(mEtfClamp * static_cast<double>(future)));
+    delta -= delta % mTickSize;
+    const long clamped = std::clamp(static_cast<long>(etfPrice), future - delta, future + delta);
+
+    mProfitOrLoss = mAccountBalance + mFuturePosition * future + mEtfPosition * clamped;
+    mMaxProfit = std::max(mMaxProfit, mProfitOrLoss);
+    mMaxDrawdown = std::max(mMaxDrawdown, mMaxProfit - mProfitOrLoss);
+}
+
+}
@@ -0,0 +1,65 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_SIMULATOR_ACCOUNT_H
+#define CPPREADY_TRADER_GO_LIBS_SIMULATOR_ACCOUNT_H
+
+#include <ready_trader_go/types.h>
+
+namespace ReadyTraderGo {
+
+// A competitor's account, as kept by the exchange simulator
+// (ready_trader_go/account.py). Amounts are in cents.
+class Account
+{
+public:
+    explicit Account(double etfClamp = 0.002, unsigned long tickSize = 100);
+
+    void Transact(Instrument instrument, Side side, unsigned long price, unsigned long volume, long fee);
+
+    // Revalue the positions: the future at its price and the ETF at its
+    // price clamped to within the ETF clamp of the future's.
+    void Update(unsigned long futurePrice, unsigned long etfPrice);
+
+    long GetAccountBalance() const noexcept { return mAccountBalance; }
+    unsigned long GetBuyVolume() const noexcept { return mBuyVolume; }
+    unsigned long GetSellVolume() const noexcept { return mSellVolume; }
+    long GetEtfPosition() const noexcept { return mEtfPosition; }
+    long GetFuturePosition() const noexcept { return mFuturePosition; }
+    long GetTotalFees() const noexcept { return mTotalFees; }
+    long GetProfitOrLoss() const noexcept { return mProfitOrLoss; }
+    long GetMaxProfit() const noexcept { return mMaxProfit; }
+    long GetMaxDrawdown() const noexcept { return mMaxDrawdown; }
+
+private:
+    double mEtfClamp;
+    long mTickSize;
+
+    long mAccountBalance = 0;
+    unsigned long mBuyVolume = 0;
+    unsigned long mSellVolume = 0;
+    long mEtfPosition = 0;
+    long mFuturePosition = 0;
+    long mTotalFees = 0;
+    long mProfitOrLoss = 0;
+    long mMaxProfit = 0;
+    long mMaxDrawdown = 0;
+};
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_SIMULATOR_ACCOUNT_H
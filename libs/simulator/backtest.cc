@@ -0,0 +1,504 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <memory>
+
+#include "backtest.h"
+
+namespace ReadyTraderGo {
+
+static_assert(ErrorMessage::Schema::SIZE <= OrderBookMessage::Schema::SIZE);
+static_assert(TradeTicksMessage::Schema::SIZE <= OrderBookMessage::Schema::SIZE);
+
+// The price used to value a position: the last traded price or, if nothing
+// has traded, the midpoint (zero if that cannot be found either).
+static unsigned long markPrice(const OrderBook& book)
+{
+    if (book.LastTradedPrice() != 0)
+        return book.LastTradedPrice();
+    if (book.BestAsk() == 0 || book.BestBid() == 0)
+        return 0;
+    return static_cast<unsigned long>(std::nearbyint((book.BestAsk() + book.BestBid()) / 2.0));
+}
+
+Backtest::Backtest(const std::vector<MarketEvent>& events, BaseAutoTrader& trader, const BacktestConfig& config)
+    : mTrader(trader),
+      mConnection(nullptr),
+      mConfig(config),
+      mReplay(events, config.mTickInterval, config.mMarketEventInterval, config.mEtfMakerFee, config.mEtfTakerFee),
+      mAccount(config.mEtfClamp, config.mTickSize)
+{
+    mTimerStart = TimerService::Clock::now();
+    mTrader.GetTimers().AdvanceTo(mTimerStart);
+
+    auto connection = std::make_unique<RecordingConnection>();
+    mConnection = connection.get();
+    mConnection->MessageSent = [this](unsigned char type, unsigned char const* data, std::size_t size) {
+        ++mMessagesSent;
+        if (size > MESSAGE_CAPACITY)
+            return;
+        InFlight message;
+        message.mTime = mNow + mConfig.mOrderLatency;
+        message.mSequence = mNextSequence++;
+        message.mDestination = Destination::EXCHANGE;
+        message.mType = type;
+        message.mSize = size;
+        std::copy(data, data + size, message.mData.begin());
+        mInFlight.push(message);
+    };
+    mTrader.SetExecutionConnection(std::move(connection));
+
+    mReplay.OrderBookUpdated = [this](const OrderBookMessage& book) {
+        Send(Destination::TRADER_INFORMATION, mNow + mConfig.mFeedLatency, MessageType::ORDER_BOOK_UPDATE, book);
+        // The exchange values each account once per tick
+        if (book.mInstrument == Instrument::ETF)
+        {
+            const auto etfPrice = mReplay.GetOrderBook(Instrument::ETF).LastTradedPrice();
+            const auto futurePrice = mReplay.GetOrderBook(Instrument::FUTURE).LastTradedPrice();
+            if (futurePrice != 0)
+                mAccount.Update(futurePrice, etfPrice);
+            mScoreBoard.Tick(mNow, mAccount, etfPrice, futurePrice, mUnhedgedLots.GetUnhedgedLotCount());
+        }
+    };
+    mReplay.TradeTicksOccurred = [this](const TradeTicksMessage& ticks) {
+        Send(Destination::TRADER_INFORMATION, mNow + mConfig.mFeedLatency, MessageType::TRADE_TICKS, ticks);
+    };
+}
+
+bool Backtest::Step()
+{
+    // Everything that arrives before this batch of market events happens
+    // first, then the batch, then anything that arrives at the same moment
+    DeliverUntil(mReplay.GetTime(), false);
+    ExpireUnhedgedLots(mReplay.GetTime());
+    mNow = mReplay.GetTime();
+    mTrader.GetTimers().AdvanceTo(TimerTime(mNow));
+    const bool more = mReplay.Step();
+    if (mBreached && !mDisconnected)
+        Disconnect();
+    DeliverUntil(mNow, true);
+    if (!more)
+    {
+        while (!mInFlight.empty())
+            DeliverUntil(mInFlight.top().mTime, true);
+
+        // The market closes
+        mScoreBoard.Disconnect(mNow, mAccount, mReplay.GetOrderBook(Instrument::ETF).LastTradedPrice(),
+                               mReplay.GetOrderBook(Instrument::FUTURE).LastTradedPrice(),
+                               mUnhedgedLots.GetUnhedgedLotCount());
+    }
+    return more;
+}
+
+BacktestResult Backtest::GetResult() const
+{
+    BacktestResult result;
+    result.mProfitOrLoss = mAccount.GetProfitOrLoss();
+    result.mMaxDrawdown = mAccount.GetMaxDrawdown();
+    result.mTotalFees = mAccount.GetTotalFees();
+    result.mEtfPosition = mAccount.GetEtfPosition();
+    result.mFuturePosition = mAccount.GetFuturePosition();
+    result.mEtfVolume = mAccount.GetBuyVolume() + mAccount.GetSellVolume();
+    result.mMessagesSent = mMessagesSent;
+    result.mErrors = mErrors;
+    result.mBreached = mBreached;
+    result.mBreachReason = mBreachReason;
+    return result;
+}
+
+template<typename T>
+void Backtest::Send(Destination destination, double time, unsigned char type, const T& message)
+{
+    if (mBreached && destination == Destination::TRADER_EXECUTION)
+        return;
+
+    InFlight inFlight;
+    inFlight.mTime = time;
+    inFlight.mSequence = mNextSequence++;
+    inFlight.mDestination = destination;
+    inFlight.mType = type;
+    inFlight.mSize = T::Schema::SIZE;
+    T::Schema::Serialise(message, inFlight.mData.data());
+    mInFlight.push(inFlight);
+}
+
+void Backtest::DeliverUntil(double time, bool inclusive)
+{
+    for (;;)
+    {
+        const bool deliver
+            = !mInFlight.empty() && (mInFlight.top().mTime < time || (inclusive && mInFlight.top().mTime == time));
+        // A timer due first may send a message that arrives first
+        if (FireNextTimer(deliver ? mInFlight.top().mTime : time))
+            continue;
+        if (!deliver)
+            break;
+
+        ExpireUnhedgedLots(mInFlight.top().mTime);
+        const InFlight message = mInFlight.top();
+        mInFlight.pop();
+        mNow = message.mTime;
+        mTrader.GetTimers().AdvanceTo(TimerTime(mNow));
+        Deliver(message);
+        if (mBreached && !mDisconnected)
+            Disconnect();
+    }
+}
+
+// Fire the trader's timers due at the first tick of its timer wheel, if that
+// is no later than 'time'.
+bool Backtest::FireNextTimer(double time)
+{
+    auto& timers = mTrader.GetTimers();
+    if (timers.GetWheel().IsEmpty())
+        return false;
+    const auto next = timers.GetWheel().NextTick();
+    if (next > TimerTime(time))
+        return false;
+
+    const double due = std::chrono::duration<double>(next - mTimerStart).count();
+    ExpireUnhedgedLots(due);
+    mNow = std::max(mNow, due);
+    timers.AdvanceTo(next);
+    if (mBreached && !mDisconnected)
+        Disconnect();
+    return true;
+}
+
+TimerService::Clock::time_point Backtest::TimerTime(double time) const
+{
+    return mTimerStart
+           + std::chrono::duration_cast<TimerService::Clock::duration>(std::chrono::duration<double>(time));
+}
+
+void Backtest::Deliver(const InFlight& message)
+{
+    unsigned char const* data = message.mData.data();
+    switch (message.mDestination)
+    {
+    case Destination::TRADER_INFORMATION:
+        if (message.mType == MessageType::ORDER_BOOK_UPDATE)
+            mTrader.DeliverOrderBook(makeMessage<OrderBookMessage>(data, message.mSize));
+        else
+            mTrader.DeliverTradeTicks(makeMessage<TradeTicksMessage>(data, message.mSize));
+        break;
+    case Destination::TRADER_EXECUTION:
+        mConnection->Receive(message.mType, data, message.mSize);
+        break;
+    case Destination::EXCHANGE:
+        // A breached trader has been disconnected
+        if (mBreached || MessageFrequencyBreached())
+            break;
+        switch (message.mType)
+        {
+        case MessageType::AMEND_ORDER:
+            OnAmendMessage(makeMessage<AmendMessage>(data, message.mSize));
+            break;
+        case MessageType::CANCEL_ORDER:
+            OnCancelMessage(makeMessage<CancelMessage>(data, message.mSize));
+            break;
+        case MessageType::HEDGE_ORDER:
+            OnHedgeMessage(makeMessage<HedgeMessage>(data, message.mSize));
+            break;
+        case MessageType::INSERT_ORDER:
+            OnInsertMessage(makeMessage<InsertMessage>(data, message.mSize));
+            break;
+        default:
+            break;
+        }
+        break;
+    }
+}
+
+// The exchange's timer fires at the deadline, whatever else is happening.
+void Backtest::ExpireUnhedgedLots(double time)
+{
+    if (!mUnhedgedLots.HasDeadline() || mUnhedgedLots.GetDeadline() >= time)
+        return;
+
+    mUnhedgedLots.ClearDeadline();
+    mNow = mUnhedgedLots.GetDeadline();
+    HardBreach(0, "held unhedged lots for longer than the time limit");
+    if (!mDisconnected)
+        Disconnect();
+}
+
+// As the exchange's FrequencyLimiter (ready_trader_go/limiter.py).
+bool Backtest::MessageFrequencyBreached()
+{
+    mRecentMessages.push_back(mNow);
+    const double windowStart = mNow - mConfig.mMessageFrequencyInterval;
+    while ((mRecentMessages.front() - windowStart) <= std::max(mRecentMessages.front(), windowStart) * DBL_EPSILON)
+        mRecentMessages.pop_front();
+
+    if (mRecentMessages.size() > mConfig.mMessageFrequencyLimit)
+    {
+        HardBreach(0, "message frequency limit breached");
+        return true;
+    }
+    return false;
+}
+
+void Backtest::OnAmendMessage(const AmendMessage& message)
+{
+    if (message.mClientOrderId > mLastClientOrderId)
+    {
+        SendError(message.mClientOrderId, "out-of-order client_order_id in amend message");
+        return;
+    }
+
+    auto it = mOrders.find(message.mClientOrderId);
+    if (it == mOrders.end())
+        return;
+    if (message.mNewVolume > it->second.mVolume)
+        SendError(message.mClientOrderId, "amend operation would increase order volume");
+    else
+        mReplay.GetOrderBook(Instrument::ETF).Amend(mNow, it->second, message.mNewVolume);
+}
+
+void Backtest::OnCancelMessage(const CancelMessage& message)
+{
+    if (message.mClientOrderId > mLastClientOrderId)
+    {
+        SendError(message.mClientOrderId, "out-of-order client_order_id in cancel message");
+        return;
+    }
+
+    auto it = mOrders.find(message.mClientOrderId);
+    if (it != mOrders.end())
+        mReplay.GetOrderBook(Instrument::ETF).Cancel(mNow, it->second);
+}
+
+// Hedge orders are filled at the future's prices without affecting its
+// order book.
+void Backtest::OnHedgeMessage(const HedgeMessage& message)
+{
+    if (message.mClientOrderId <= mLastClientOrderId)
+    {
+        SendError(message.mClientOrderId, "duplicate or out-of-order client_order_id");
+        return;
+    }
+    mLastClientOrderId = message.mClientOrderId;
+
+    if (message.mSide != Side::BUY && message.mSide != Side::SELL)
+        SendError(message.mClientOrderId, "not a valid side");
+    else if (message.mPrice < MINIMUM_BID || message.mPrice > MAXIMUM_ASK)
+        SendError(message.mClientOrderId, "not a valid price");
+    else if (message.mPrice % mConfig.mTickSize != 0)
+        SendError(message.mClientOrderId, "price is not a multiple of tick size");
+    else if (message.mVolume < 1)
+        SendError(message.mClientOrderId, "not a valid volume");
+    else if (mNow == 0.0)
+        SendError(message.mClientOrderId, "order rejected: market not yet open");
+    else
+    {
+        const auto& future = mReplay.GetOrderBook(Instrument::FUTURE);
+        auto [volume, averagePrice] = future.TryTrade(message.mSide, message.mPrice, message.mVolume);
+        if (mNow >= mConfig.mHedgeOutageStart && mNow < mConfig.mHedgeOutageEnd)
+            volume = averagePrice = 0;
+        else if (volume == 0)
+        {
+            const auto best = message.mSide == Side::BUY ? future.BestAsk() : future.BestBid();
+            if (best == 0)
+            {
+                const auto lastTraded = future.LastTradedPrice();
+                if (lastTraded == 0)
+                {
+                    SendError(message.mClientOrderId, "order rejected: cannot determine future price");
+                    return;
+                }
+                if ((message.mSide == Side::SELL && lastTraded >= message.mPrice)
+                    || (message.mSide == Side::BUY && lastTraded <= message.mPrice))
+                    averagePrice = lastTraded;
+            }
+        }
+
+        if (averagePrice == 0)
+        {
+            Send(Destination::TRADER_EXECUTION, mNow + mConfig.mFeedLatency, MessageType::HEDGE_FILLED,
+                 HedgeFilledMessage{message.mClientOrderId, 0, 0});
+            return;
+        }
+
+        const long delta = static_cast<long>(message.mVolume);
+        mUnhedgedLots.ApplyPositionDelta(mNow, message.mSide == Side::BUY ? delta : -delta);
+        mAccount.Transact(Instrument::FUTURE, message.mSide, averagePrice, message.mVolume, 0);
+        const auto futurePrice = markPrice(future);
+        if (futurePrice != 0)
+            mAccount.Update(futurePrice, markPrice(mReplay.GetOrderBook(Instrument::ETF)));
+        Send(Destination::TRADER_EXECUTION, mNow + mConfig.mFeedLatency, MessageType::HEDGE_FILLED,
+             HedgeFilledMessage{message.mClientOrderId, averagePrice, message.mVolume});
+
+        const long position = mAccount.GetFuturePosition();
+        if (position < -mConfig.mPositionLimit || position > mConfig.mPositionLimit)
+            HardBreach(message.mClientOrderId, "future position limit breached");
+    }
+}
+
+void Backtest::OnInsertMessage(const InsertMessage& message)
+{
+    if (message.mClientOrderId <= mLastClientOrderId)
+    {
+        SendError(message.mClientOrderId, "duplicate or out-of-order client_order_id");
+        return;
+    }
+    mLastClientOrderId = message.mClientOrderId;
+
+    if (message.mSide != Side::BUY && message.mSide != Side::SELL)
+        SendError(message.mClientOrderId, "not a valid side");
+    else if (message.mLifespan != Lifespan::FILL_AND_KILL && message.mLifespan != Lifespan::GOOD_FOR_DAY)
+        SendError(message.mClientOrderId, "not a valid lifespan");
+    else if (message.mPrice < MINIMUM_BID || message.mPrice > MAXIMUM_ASK)
+        SendError(message.mClientOrderId, "not a valid price");
+    else if (message.mPrice % mConfig.mTickSize != 0)
+        SendError(message.mClientOrderId, "price is not a multiple of tick size");
+    else if (mOrders.size() == mConfig.mActiveOrderCountLimit)
+        SendError(message.mClientOrderId, "order rejected: active order count limit breached");
+    else if (message.mVolume < 1)
+        SendError(message.mClientOrderId, "not a valid volume");
+    else if (mActiveVolume + message.mVolume > mConfig.mActiveVolumeLimit)
+        SendError(message.mClientOrderId, "order rejected: active order volume limit breached");
+    else if (mNow == 0.0)
+        SendError(message.mClientOrderId, "order rejected: market not yet open");
+    else if ((message.mSide == Side::BUY && !mSellPrices.empty() && message.mPrice >= *mSellPrices.begin())
+             || (message.mSide == Side::SELL && !mBuyPrices.empty() && message.mPrice <= *mBuyPrices.rbegin()))
+        SendError(message.mClientOrderId, "order rejected: in cross with an existing order");
+    else
+    {
+        SimulatedOrder& order = mOrders[message.mClientOrderId];
+        order.mClientOrderId = message.mClientOrderId;
+        order.mInstrument = Instrument::ETF;
+        order.mLifespan = message.mLifespan;
+        order.mSide = message.mSide;
+        order.mPrice = message.mPrice;
+        order.mVolume = order.mRemainingVolume = message.mVolume;
+        order.mListener = this;
+        (order.mSide == Side::BUY ? mBuyPrices : mSellPrices).insert(order.mPrice);
+        mActiveVolume += order.mVolume;
+
+        // The book still refers to the order after its callbacks, so it is
+        // only forgotten once the insert is complete
+        mAggressor = &order;
+        mReplay.GetOrderBook(Instrument::ETF).Insert(mNow, order);
+        mAggressor = nullptr;
+        if (order.mRemainingVolume == 0)
+            Forget(order);
+    }
+}
+
+void Backtest::OnOrderAmended(double, SimulatedOrder& order, unsigned long volumeRemoved)
+{
+    SendOrderStatus(order, order.mVolume - order.mRemainingVolume);
+    mActiveVolume -= volumeRemoved;
+    if (order.mRemainingVolume == 0)
+        Forget(order);
+}
+
+void Backtest::OnOrderCancelled(double, SimulatedOrder& order, unsigned long volumeRemoved)
+{
+    SendOrderStatus(order, order.mVolume - volumeRemoved);
+    mActiveVolume -= volumeRemoved;
+    if (&order != mAggressor)
+        Forget(order);
+}
+
+void Backtest::OnOrderPlaced(double, SimulatedOrder& order)
+{
+    if (order.mVolume == order.mRemainingVolume)
+        SendOrderStatus(order, 0);
+}
+
+void Backtest::OnOrderFilled(double, SimulatedOrder& order, unsigned long price, unsigned long volume, long fee)
+{
+    mActiveVolume -= volume;
+
+    const long delta = static_cast<long>(volume);
+    mUnhedgedLots.ApplyPositionDelta(mNow, order.mSide == Side::BUY ? delta : -delta);
+    const auto futurePrice = markPrice(mReplay.GetOrderBook(Instrument::FUTURE));
+    mAccount.Transact(Instrument::ETF, order.mSide, price, volume, fee);
+    if (futurePrice != 0)
+        mAccount.Update(futurePrice, price);
+
+    Send(Destination::TRADER_EXECUTION, mNow + mConfig.mFeedLatency, MessageType::ORDER_FILLED,
+         OrderFilledMessage{order.mClientOrderId, price, volume});
+    SendOrderStatus(order, order.mVolume - order.mRemainingVolume);
+
+    const unsigned long clientOrderId = order.mClientOrderId;
+    if (order.mRemainingVolume == 0 && &order != mAggressor)
+        Forget(order);
+
+    const long position = mAccount.GetEtfPosition();
+    if (position < -mConfig.mPositionLimit || position > mConfig.mPositionLimit)
+        HardBreach(clientOrderId, "ETF position limit breached");
+}
+
+void Backtest::Forget(SimulatedOrder& order)
+{
+    auto& prices = order.mSide == Side::BUY ? mBuyPrices : mSellPrices;
+    auto price = prices.find(order.mPrice);
+    if (price != prices.end())
+        prices.erase(price);
+    mOrders.erase(order.mClientOrderId);
+}
+
+// The exchange disconnects a trader that breaches a hard limit. Nothing more
+// is sent to the trader, and its orders are cancelled once the order book
+// has finished the operation that caused the breach.
+void Backtest::HardBreach(unsigned long clientOrderId, const char* reason)
+{
+    if (mBreached)
+        return;
+    SendError(clientOrderId, reason);
+    mBreached = true;
+    mBreachReason = reason;
+    mScoreBoard.Breach(mNow, mAccount, mReplay.GetOrderBook(Instrument::ETF).LastTradedPrice(),
+                       mReplay.GetOrderBook(Instrument::FUTURE).LastTradedPrice(),
+                       mUnhedgedLots.GetUnhedgedLotCount());
+}
+
+void Backtest::Disconnect()
+{
+    mDisconnected = true;
+    std::vector<unsigned long> resting;
+    for (const auto& entry : mOrders)
+        resting.push_back(entry.first);
+    for (auto id : resting)
+    {
+        auto it = mOrders.find(id);
+        if (it != mOrders.end())
+            mReplay.GetOrderBook(Instrument::ETF).Cancel(mNow, it->second);
+    }
+}
+
+void Backtest::SendError(unsigned long clientOrderId, const char* message)
+{
+    ++mErrors;
+    Send(Destination::TRADER_EXECUTION, mNow + mConfig.mFeedLatency, MessageType::ERROR_MESSAGE,
+         ErrorMessage{clientOrderId, message});
+}
+
+void Backtest::SendOrderStatus(const SimulatedOrder& order, unsigned long fillVolume)
+{
+    Send(Destination::TRADER_EXECUTION, mNow + mConfig.mFeedLatency, MessageType::ORDER_STATUS,
+         OrderStatusMessage{order.mClientOrderId, fillVolume, order.mRemainingVolume, order.mTotalFees});
+}
+
+}
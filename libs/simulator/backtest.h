@@ -0,0 +1,217 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_SIMULATOR_BACKTEST_H
+#define CPPREADY_TRADER_GO_LIBS_SIMULATOR_BACKTEST_H
+
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <queue>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ready_trader_go/baseautotrader.h>
+#include <ready_trader_go/protocol.h>
+#include <ready_trader_go/types.h>
+#include <ready_trader_go/unhedgedlots.h>
+
+#include "account.h"
+#include "marketdata.h"
+#include "marketreplay.h"
+#include "orderbook.h"
+#include "recordingconnection.h"
+#include "scoreboard.h"
+
+namespace ReadyTraderGo {
+
+// The exchange's settings (see exchange.json) and the latencies between it
+// and the trader. Latencies are one-way, in seconds of simulated time.
+struct BacktestConfig
+{
+    // Everything the exchange sends the trader: information and execution
+    double mFeedLatency = 0.0;
+    // Everything the trader sends the exchange
+    double mOrderLatency = 0.0;
+
+    double mTickInterval = DEFAULT_TICK_INTERVAL;
+    double mMarketEventInterval = DEFAULT_MARKET_EVENT_INTERVAL;
+    double mEtfMakerFee = DEFAULT_ETF_MAKER_FEE;
+    double mEtfTakerFee = DEFAULT_ETF_TAKER_FEE;
+    double mEtfClamp = 0.002;
+    unsigned long mTickSize = 100;
+
+    unsigned long mActiveOrderCountLimit = 10;
+    unsigned long mActiveVolumeLimit = 200;
+    double mMessageFrequencyInterval = 1.0;
+    unsigned long mMessageFrequencyLimit = 50;
+    long mPositionLimit = 100;
+
+    // Hedge orders that arrive from the start of the outage until its end
+    // are unsuccessful, as though the future had nothing to trade against,
+    // so that the trader's handling of unhedged lots can be tested
+    double mHedgeOutageStart = 0.0;
+    double mHedgeOutageEnd = 0.0;
+};
+
+// The trader's account at the end of a backtest, in cents.
+struct BacktestResult
+{
+    long mProfitOrLoss = 0;
+    long mMaxDrawdown = 0;
+    long mTotalFees = 0;
+    long mEtfPosition = 0;
+    long mFuturePosition = 0;
+    unsigned long mEtfVolume = 0;
+    unsigned long mMessagesSent = 0;
+    unsigned long mErrors = 0;
+    bool mBreached = false;
+    std::string mBreachReason;
+};
+
+// Runs a trader against a replayed market as the exchange simulator would,
+// but in simulated time and as fast as possible.
+//
+// The trader's orders join the same order books as the replayed market's,
+// so they queue behind the volume already resting at their price and are
+// filled by the market's later orders in price-time priority. Order books
+// are published once per tick interval, trade ticks after each batch of
+// market events, and fills, fees, limits and errors follow the exchange
+// (ready_trader_go/competitor.py). Each message between the exchange and
+// the trader is delayed by the configured latency, so the same data can be
+// replayed at several latencies to see what a faster trader would earn.
+// The trader's account is valued and recorded in the score board each tick,
+// and holding unhedged lots for too long is a breach. The trader's timers
+// run in simulated time, firing between messages at the time they are due.
+//
+// Trade ticks caused by the trader's own orders are published with the next
+// batch of market events rather than immediately.
+class Backtest : public IOrderListener
+{
+public:
+    // Replaces the trader's execution connection. The events and the trader
+    // must outlive the backtest.
+    Backtest(const std::vector<MarketEvent>& events, BaseAutoTrader& trader, const BacktestConfig& config = {});
+
+    Backtest(const Backtest&) = delete;
+    void operator=(const Backtest&) = delete;
+
+    // Replay one batch of market events, and everything that happens
+    // between the trader and the exchange up to the next. Returns false
+    // once every event has been replayed.
+    bool Step();
+    BacktestResult Run();
+
+    double GetTime() const noexcept { return mNow; }
+    BacktestResult GetResult() const;
+    const Account& GetAccount() const noexcept { return mAccount; }
+    const ScoreBoard& GetScoreBoard() const noexcept { return mScoreBoard; }
+
+    // IOrderListener callbacks for the trader's orders
+    void OnOrderAmended(double now, SimulatedOrder& order, unsigned long volumeRemoved) override;
+    void OnOrderCancelled(double now, SimulatedOrder& order, unsigned long volumeRemoved) override;
+    void OnOrderPlaced(double now, SimulatedOrder& order) override;
+    void OnOrderFilled(double now, SimulatedOrder& order, unsigned long price, unsigned long volume, long fee) override;
+
+private:
+    enum class Destination : unsigned char { EXCHANGE, TRADER_EXECUTION, TRADER_INFORMATION };
+
+    // The largest message either side sends
+    static constexpr std::size_t MESSAGE_CAPACITY = OrderBookMessage::Schema::SIZE;
+
+    // A message on its way to the exchange or the trader.
+    struct InFlight
+    {
+        double mTime = 0.0;
+        unsigned long mSequence = 0;
+        Destination mDestination = Destination::EXCHANGE;
+        unsigned char mType = 0;
+        std::size_t mSize = 0;
+        std::array<unsigned char, MESSAGE_CAPACITY> mData = {};
+    };
+
+    struct Later
+    {
+        bool operator()(const InFlight& a, const InFlight& b) const noexcept
+        {
+            return a.mTime > b.mTime || (a.mTime == b.mTime && a.mSequence > b.mSequence);
+        }
+    };
+
+    template<typename T>
+    void Send(Destination destination, double time, unsigned char type, const T& message);
+
+    void Deliver(const InFlight& message);
+    void DeliverUntil(double time, bool inclusive);
+    void ExpireUnhedgedLots(double time);
+    bool FireNextTimer(double time);
+    TimerService::Clock::time_point TimerTime(double time) const;
+
+    void OnAmendMessage(const AmendMessage& message);
+    void OnCancelMessage(const CancelMessage& message);
+    void OnHedgeMessage(const HedgeMessage& message);
+    void OnInsertMessage(const InsertMessage& message);
+
+    void Disconnect();
+    void Forget(SimulatedOrder& order);
+    void HardBreach(unsigned long clientOrderId, const char* reason);
+    bool MessageFrequencyBreached();
+    void SendError(unsigned long clientOrderId, const char* message);
+    void SendOrderStatus(const SimulatedOrder& order, unsigned long fillVolume);
+
+    BaseAutoTrader& mTrader;
+    RecordingConnection* mConnection;
+    BacktestConfig mConfig;
+    MarketReplay mReplay;
+    double mNow = 0.0;
+    // Simulated time zero on the trader's timers' clock
+    TimerService::Clock::time_point mTimerStart;
+
+    std::priority_queue<InFlight, std::vector<InFlight>, Later> mInFlight;
+    unsigned long mNextSequence = 0;
+    std::deque<double> mRecentMessages;
+
+    // The trader's resting orders, as the exchange sees them
+    std::unordered_map<unsigned long, SimulatedOrder> mOrders;
+    SimulatedOrder* mAggressor = nullptr;
+    std::multiset<unsigned long> mBuyPrices;
+    std::multiset<unsigned long> mSellPrices;
+    unsigned long mActiveVolume = 0;
+    unsigned long mLastClientOrderId = 0;
+
+    Account mAccount;
+    UnhedgedLots mUnhedgedLots;
+    ScoreBoard mScoreBoard;
+    unsigned long mMessagesSent = 0;
+    unsigned long mErrors = 0;
+    bool mBreached = false;
+    bool mDisconnected = false;
+    std::string mBreachReason;
+};
+
+inline BacktestResult Backtest::Run()
+{
+    while (Step())
+        ;
+    return GetResult();
+}
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_SIMULATOR_BACKTEST_H
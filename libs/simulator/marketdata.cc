@@ -0,0 +1,128 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <array>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+
+#include <ready_trader_go/error.h>
+
+#include "marketdata.h"
+
+namespace ReadyTraderGo {
+
+constexpr std::size_t MARKET_DATA_FIELD_COUNT = 8;
+
+static Side parseSide(std::string_view field)
+{
+    if (field.empty())
+        return Side::SELL;
+    return (field[0] == 'B') ? Side::BUY : Side::SELL;
+}
+
+static Lifespan parseLifespan(std::string_view field)
+{
+    if (field.empty())
+        return Lifespan::GOOD_FOR_DAY;
+    return (field[0] == 'F' || field[0] == 'I') ? Lifespan::FILL_AND_KILL : Lifespan::GOOD_FOR_DAY;
+}
+
+static MarketEventOperation parseOperation(std::string_view field, std::size_t lineNumber)
+{
+    if (field == "Insert")
+        return MarketEventOperation::INSERT;
+    if (field == "Cancel")
+        return MarketEventOperation::CANCEL;
+    if (field == "Amend")
+        return MarketEventOperation::AMEND;
+    throw ReadyTraderGoError("market data line " + std::to_string(lineNumber) + ": unknown operation '"
+                             + std::string(field) + "'");
+}
+
+// Numbers are converted as the exchange simulator converts them, i.e. by
+// truncating the (scaled) floating point value.
+static double parseDouble(std::string_view field)
+{
+    return field.empty() ? 0.0 : std::strtod(field.data(), nullptr);
+}
+
+std::vector<MarketEvent> readMarketData(const std::string& filename)
+{
+    std::ifstream file{filename, std::ios::binary};
+    if (!file)
+        throw ReadyTraderGoError("failed to open market data file: '" + filename + "'");
+
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    const std::string text = contents.str();
+
+    std::vector<MarketEvent> events;
+    events.reserve(text.size() / 32);
+
+    std::size_t lineNumber = 0;
+    std::size_t start = 0;
+    while (start < text.size())
+    {
+        std::size_t end = text.find('\n', start);
+        if (end == std::string::npos)
+            end = text.size();
+        std::string_view line{text.data() + start, end - start};
+        start = end + 1;
+
+        if (++lineNumber == 1)
+            continue; // Header row
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        if (line.empty())
+            continue;
+
+        std::array<std::string_view, MARKET_DATA_FIELD_COUNT> fields;
+        std::size_t count = 0;
+        for (std::size_t pos = 0; count < MARKET_DATA_FIELD_COUNT; ++count)
+        {
+            const std::size_t comma = line.find(',', pos);
+            fields[count] = line.substr(pos, comma - pos);
+            if (comma == std::string_view::npos)
+            {
+                ++count;
+                break;
+            }
+            pos = comma + 1;
+        }
+        if (count != MARKET_DATA_FIELD_COUNT)
+        {
+            throw ReadyTraderGoError("market data line " + std::to_string(lineNumber) + " of '" + filename
+                                     + "' does not have " + std::to_string(MARKET_DATA_FIELD_COUNT) + " fields");
+        }
+
+        MarketEvent& event = events.emplace_back();
+        event.mTime = parseDouble(fields[0]);
+        event.mInstrument = Instrument(std::strtoul(fields[1].data(), nullptr, 10));
+        event.mOperation = parseOperation(fields[2], lineNumber);
+        event.mOrderId = std::strtoul(fields[3].data(), nullptr, 10);
+        event.mSide = parseSide(fields[4]);
+        event.mVolume = static_cast<long>(parseDouble(fields[5]));
+        event.mPrice = static_cast<unsigned long>(parseDouble(fields[6]) * MARKET_DATA_PRICE_SCALE);
+        event.mLifespan = parseLifespan(fields[7]);
+    }
+
+    return events;
+}
+
+}
@@ -0,0 +1,53 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_SIMULATOR_MARKETDATA_H
+#define CPPREADY_TRADER_GO_LIBS_SIMULATOR_MARKETDATA_H
+
+#include <string>
+#include <vector>
+
+#include <ready_trader_go/types.h>
+
+namespace ReadyTraderGo {
+
+// Prices in market data files are in dollars; the exchange works in cents.
+constexpr int MARKET_DATA_PRICE_SCALE = 100;
+
+enum class MarketEventOperation : unsigned char { AMEND, CANCEL, INSERT };
+
+// One row of a market data file (see data/market_data*.csv).
+struct MarketEvent
+{
+    double mTime = 0.0;
+    Instrument mInstrument = Instrument::FUTURE;
+    MarketEventOperation mOperation = MarketEventOperation::INSERT;
+    unsigned long mOrderId = 0;
+    Side mSide = Side::SELL;
+    // For an amendment, the (negative) change in volume
+    long mVolume = 0;
+    unsigned long mPrice = 0;
+    Lifespan mLifespan = Lifespan::GOOD_FOR_DAY;
+};
+
+// Read every event in a market data file. Throws ReadyTraderGoError if the
+// file cannot be read or is malformed.
+std::vector<MarketEvent> readMarketData(const std::string& filename);
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_SIMULATOR_MARKETDATA_H
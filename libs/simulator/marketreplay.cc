@@ -0,0 +1,135 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include "marketreplay.h"
+
+namespace ReadyTraderGo {
+
+MarketReplay::MarketReplay(const std::vector<MarketEvent>& events,
+                           double tickInterval,
+                           double marketEventInterval,
+                           double etfMakerFee,
+                           double etfTakerFee)
+    : mEvents(events),
+      mTickInterval(tickInterval),
+      mMarketEventInterval(marketEventInterval),
+      mFutureBook(Instrument::FUTURE, 0.0, 0.0),
+      mEtfBook(Instrument::ETF, etfMakerFee, etfTakerFee)
+{
+}
+
+bool MarketReplay::Step()
+{
+    while (mNextEvent < mEvents.size() && mEvents[mNextEvent].mTime < mNow)
+    {
+        ApplyEvent(mEvents[mNextEvent++]);
+    }
+
+    PublishTradeTicks();
+
+    if (mNow >= mNextTickTime)
+    {
+        PublishOrderBooks();
+        ++mTickNumber;
+        mNextTickTime = static_cast<double>(mTickNumber - 1) * mTickInterval;
+    }
+
+    mNow = static_cast<double>(++mStep) * mMarketEventInterval;
+    return mNextEvent < mEvents.size();
+}
+
+// Orders are only forgotten once the order book has finished with them:
+// passive orders as they are filled, other orders when the operation that
+// affected them completes.
+void MarketReplay::ApplyEvent(const MarketEvent& event)
+{
+    auto& orders = mOrders[static_cast<int>(event.mInstrument)];
+    auto& book = GetOrderBook(event.mInstrument);
+
+    if (event.mOperation == MarketEventOperation::INSERT)
+    {
+        auto [it, inserted] = orders.try_emplace(event.mOrderId);
+        if (!inserted)
+            return;
+        SimulatedOrder& order = it->second;
+        order.mClientOrderId = event.mOrderId;
+        order.mInstrument = event.mInstrument;
+        order.mLifespan = event.mLifespan;
+        order.mSide = event.mSide;
+        order.mPrice = event.mPrice;
+        order.mVolume = order.mRemainingVolume = static_cast<unsigned long>(event.mVolume);
+        order.mListener = nullptr;
+        book.Insert(event.mTime, order);
+        if (order.mRemainingVolume == 0)
+            orders.erase(it);
+        else
+            order.mListener = this;
+        return;
+    }
+
+    auto it = orders.find(event.mOrderId);
+    if (it == orders.end())
+        return;
+
+    SimulatedOrder& order = it->second;
+    if (event.mOperation == MarketEventOperation::CANCEL)
+        book.Cancel(event.mTime, order);
+    else if (event.mVolume < 0)
+    {
+        const auto reduction = static_cast<unsigned long>(-event.mVolume);
+        book.Amend(event.mTime, order, reduction < order.mVolume ? order.mVolume - reduction : 0);
+    }
+
+    if (order.mRemainingVolume == 0)
+        orders.erase(it);
+}
+
+void MarketReplay::OnOrderFilled(double, SimulatedOrder& order, unsigned long, unsigned long, long)
+{
+    if (order.mRemainingVolume == 0)
+        mOrders[static_cast<int>(order.mInstrument)].erase(order.mClientOrderId);
+}
+
+void MarketReplay::PublishOrderBooks()
+{
+    for (auto* book : {&mFutureBook, &mEtfBook})
+    {
+        mBookMessage.mInstrument = book->GetInstrument();
+        mBookMessage.mSequenceNumber = mTickNumber;
+        book->TopLevels(mBookMessage.mAskPrices, mBookMessage.mAskVolumes,
+                        mBookMessage.mBidPrices, mBookMessage.mBidVolumes);
+        if (OrderBookUpdated)
+            OrderBookUpdated(mBookMessage);
+    }
+}
+
+void MarketReplay::PublishTradeTicks()
+{
+    for (auto* book : {&mFutureBook, &mEtfBook})
+    {
+        if (book->TradeTicks(mTicksMessage.mAskPrices, mTicksMessage.mAskVolumes,
+                             mTicksMessage.mBidPrices, mTicksMessage.mBidVolumes))
+        {
+            mTicksMessage.mInstrument = book->GetInstrument();
+            mTicksMessage.mSequenceNumber = ++mTradeTicksSequences[static_cast<int>(book->GetInstrument())];
+            if (TradeTicksOccurred)
+                TradeTicksOccurred(mTicksMessage);
+        }
+    }
+}
+
+}
@@ -0,0 +1,108 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_SIMULATOR_MARKETREPLAY_H
+#define CPPREADY_TRADER_GO_LIBS_SIMULATOR_MARKETREPLAY_H
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <ready_trader_go/protocol.h>
+#include <ready_trader_go/types.h>
+
+#include "marketdata.h"
+#include "orderbook.h"
+
+namespace ReadyTraderGo {
+
+// Defaults from exchange.json
+constexpr double DEFAULT_TICK_INTERVAL = 0.25;
+constexpr double DEFAULT_MARKET_EVENT_INTERVAL = 0.05;
+constexpr double DEFAULT_ETF_MAKER_FEE = -0.0001;
+constexpr double DEFAULT_ETF_TAKER_FEE = 0.0002;
+
+// Replays a market data file through an order book for each instrument, in
+// simulated time and as fast as possible, producing the information
+// messages the exchange simulator would publish: trade ticks after each
+// batch of market events and order book snapshots once per tick interval.
+class MarketReplay : public IOrderListener
+{
+public:
+    // The events must outlive the replay.
+    explicit MarketReplay(const std::vector<MarketEvent>& events,
+                          double tickInterval = DEFAULT_TICK_INTERVAL,
+                          double marketEventInterval = DEFAULT_MARKET_EVENT_INTERVAL,
+                          double etfMakerFee = DEFAULT_ETF_MAKER_FEE,
+                          double etfTakerFee = DEFAULT_ETF_TAKER_FEE);
+
+    // Advance simulated time by one market event interval, applying the
+    // events due and publishing any messages. Returns false once every
+    // event has been replayed.
+    bool Step();
+    void Run();
+
+    double GetTime() const noexcept { return mNow; }
+    unsigned long GetTickNumber() const noexcept { return mTickNumber; }
+    OrderBook& GetOrderBook(Instrument instrument) noexcept;
+
+    std::function<void(const OrderBookMessage&)> OrderBookUpdated;
+    std::function<void(const TradeTicksMessage&)> TradeTicksOccurred;
+
+    // IOrderListener callbacks for the market's own orders
+    void OnOrderFilled(double now, SimulatedOrder& order, unsigned long price, unsigned long volume, long fee) override;
+
+private:
+    void ApplyEvent(const MarketEvent& event);
+    void PublishOrderBooks();
+    void PublishTradeTicks();
+
+    const std::vector<MarketEvent>& mEvents;
+    std::size_t mNextEvent = 0;
+
+    double mTickInterval;
+    double mMarketEventInterval;
+    unsigned long mStep = 0;
+    double mNow = 0.0;
+    double mNextTickTime = 0.0;
+    unsigned long mTickNumber = 1;
+
+    OrderBook mFutureBook;
+    OrderBook mEtfBook;
+    std::array<std::unordered_map<unsigned long, SimulatedOrder>, 2> mOrders;
+    std::array<unsigned long, 2> mTradeTicksSequences = {1, 1};
+
+    OrderBookMessage mBookMessage;
+    TradeTicksMessage mTicksMessage;
+};
+
+inline void MarketReplay::Run()
+{
+    while (Step())
+        ;
+}
+
+inline OrderBook& MarketReplay::GetOrderBook(Instrument instrument) noexcept
+{
+    return instrument == Instrument::FUTURE ? mFutureBook : mEtfBook;
+}
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_SIMULATOR_MARKETREPLAY_H
@@ -0,0 +1,262 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+#include <cmath>
+
+#include "orderbook.h"
+
+namespace ReadyTraderGo {
+
+// Fees are rounded half to even, as Python's round() does.
+static inline long fee(unsigned long price, unsigned long volume, double rate)
+{
+    return static_cast<long>(std::nearbyint(static_cast<double>(price * volume) * rate));
+}
+
+OrderBook::OrderBook(Instrument instrument, double makerFee, double takerFee)
+    : mInstrument(instrument), mMakerFee(makerFee), mTakerFee(takerFee)
+{
+}
+
+void OrderBook::Amend(double now, SimulatedOrder& order, unsigned long newVolume)
+{
+    if (order.mRemainingVolume == 0 || newVolume >= order.mVolume)
+        return;
+
+    const unsigned long fillVolume = order.mVolume - order.mRemainingVolume;
+    const unsigned long diff = order.mVolume - std::max(newVolume, fillVolume);
+    RemoveFromLevel(order, diff);
+    order.mVolume -= diff;
+    order.mRemainingVolume -= diff;
+    if (order.mListener)
+        order.mListener->OnOrderAmended(now, order, diff);
+}
+
+void OrderBook::Cancel(double now, SimulatedOrder& order)
+{
+    if (order.mRemainingVolume == 0)
+        return;
+
+    const unsigned long remaining = order.mRemainingVolume;
+    RemoveFromLevel(order, remaining);
+    order.mRemainingVolume = 0;
+    if (order.mListener)
+        order.mListener->OnOrderCancelled(now, order, remaining);
+}
+
+void OrderBook::Insert(double now, SimulatedOrder& order)
+{
+    if (order.mSide == Side::SELL && !mBids.empty() && order.mPrice <= mBids.begin()->first)
+        Trade(now, order, mBids);
+    else if (order.mSide == Side::BUY && !mAsks.empty() && order.mPrice >= mAsks.begin()->first)
+        Trade(now, order, mAsks);
+
+    if (order.mRemainingVolume > 0)
+    {
+        if (order.mLifespan == Lifespan::FILL_AND_KILL)
+        {
+            const unsigned long remaining = order.mRemainingVolume;
+            order.mRemainingVolume = 0;
+            if (order.mListener)
+                order.mListener->OnOrderCancelled(now, order, remaining);
+        }
+        else
+        {
+            Place(now, order);
+        }
+    }
+}
+
+unsigned long OrderBook::VolumeAt(Side side, unsigned long price) const
+{
+    if (side == Side::SELL)
+    {
+        auto level = mAsks.find(price);
+        return level != mAsks.end() ? level->second.mTotalVolume : 0;
+    }
+    auto level = mBids.find(price);
+    return level != mBids.end() ? level->second.mTotalVolume : 0;
+}
+
+void OrderBook::TopLevels(LevelArray& askPrices,
+                          LevelArray& askVolumes,
+                          LevelArray& bidPrices,
+                          LevelArray& bidVolumes) const
+{
+    askPrices.fill(0);
+    askVolumes.fill(0);
+    bidPrices.fill(0);
+    bidVolumes.fill(0);
+
+    std::size_t i = 0;
+    for (auto level = mAsks.begin(); level != mAsks.end() && i < TOP_LEVEL_COUNT; ++level, ++i)
+    {
+        askPrices[i] = level->first;
+        askVolumes[i] = level->second.mTotalVolume;
+    }
+
+    i = 0;
+    for (auto level = mBids.begin(); level != mBids.end() && i < TOP_LEVEL_COUNT; ++level, ++i)
+    {
+        bidPrices[i] = level->first;
+        bidVolumes[i] = level->second.mTotalVolume;
+    }
+}
+
+bool OrderBook::TradeTicks(LevelArray& askPrices,
+                           LevelArray& askVolumes,
+                           LevelArray& bidPrices,
+                           LevelArray& bidVolumes)
+{
+    if (mAskTicks.empty() && mBidTicks.empty())
+        return false;
+
+    askPrices.fill(0);
+    askVolumes.fill(0);
+    bidPrices.fill(0);
+    bidVolumes.fill(0);
+
+    std::size_t i = 0;
+    for (auto tick = mAskTicks.begin(); tick != mAskTicks.end() && i < TOP_LEVEL_COUNT; ++tick, ++i)
+    {
+        askPrices[i] = tick->first;
+        askVolumes[i] = tick->second;
+    }
+
+    i = 0;
+    for (auto tick = mBidTicks.begin(); tick != mBidTicks.end() && i < TOP_LEVEL_COUNT; ++tick, ++i)
+    {
+        bidPrices[i] = tick->first;
+        bidVolumes[i] = tick->second;
+    }
+
+    mAskTicks.clear();
+    mBidTicks.clear();
+    return true;
+}
+
+std::pair<unsigned long, unsigned long> OrderBook::TryTrade(Side side,
+                                                            unsigned long limitPrice,
+                                                            unsigned long volume) const
+{
+    unsigned long totalVolume = 0;
+    unsigned long totalValue = 0;
+
+    auto walk = [&](const auto& levels, auto crosses) {
+        for (auto level = levels.begin(); level != levels.end() && totalVolume < volume; ++level)
+        {
+            if (!crosses(level->first))
+                break;
+            const unsigned long weight = std::min(volume - totalVolume, level->second.mTotalVolume);
+            totalVolume += weight;
+            totalValue += weight * level->first;
+        }
+    };
+
+    if (side == Side::SELL)
+        walk(mBids, [limitPrice](unsigned long price) { return price >= limitPrice; });
+    else
+        walk(mAsks, [limitPrice](unsigned long price) { return price <= limitPrice; });
+
+    return {totalVolume, totalVolume > 0 ? totalValue / totalVolume : 0};
+}
+
+template<typename Levels>
+void OrderBook::Trade(double now, SimulatedOrder& order, Levels& levels)
+{
+    while (order.mRemainingVolume > 0 && !levels.empty())
+    {
+        auto best = levels.begin();
+        const unsigned long price = best->first;
+        if (order.mSide == Side::SELL ? price < order.mPrice : price > order.mPrice)
+            break;
+
+        TradeLevel(now, order, price, best->second);
+        if (best->second.mTotalVolume == 0)
+            levels.erase(best);
+    }
+}
+
+void OrderBook::TradeLevel(double now, SimulatedOrder& order, unsigned long price, Level& level)
+{
+    unsigned long remaining = order.mRemainingVolume;
+
+    while (remaining > 0 && level.mTotalVolume > 0)
+    {
+        SimulatedOrder* passive = level.mOrders.front();
+        const unsigned long volume = std::min(remaining, passive->mRemainingVolume);
+        const long passiveFee = fee(price, volume, mMakerFee);
+        level.mTotalVolume -= volume;
+        remaining -= volume;
+        passive->mRemainingVolume -= volume;
+        passive->mTotalFees += passiveFee;
+        if (passive->mRemainingVolume == 0)
+            level.mOrders.pop_front();
+        if (passive->mListener)
+            passive->mListener->OnOrderFilled(now, *passive, price, volume, passiveFee);
+    }
+
+    const unsigned long traded = order.mRemainingVolume - remaining;
+    if (order.mSide == Side::BUY)
+        mAskTicks[price] += traded;
+    else
+        mBidTicks[price] += traded;
+
+    const long aggressorFee = fee(price, traded, mTakerFee);
+    order.mRemainingVolume = remaining;
+    order.mTotalFees += aggressorFee;
+    if (order.mListener)
+        order.mListener->OnOrderFilled(now, order, price, traded, aggressorFee);
+
+    mLastTradedPrice = price;
+}
+
+void OrderBook::Place(double now, SimulatedOrder& order)
+{
+    Level& level = order.mSide == Side::SELL ? mAsks[order.mPrice] : mBids[order.mPrice];
+    level.mOrders.push_back(&order);
+    level.mTotalVolume += order.mRemainingVolume;
+    if (order.mListener)
+        order.mListener->OnOrderPlaced(now, order);
+}
+
+void OrderBook::RemoveFromLevel(SimulatedOrder& order, unsigned long volume)
+{
+    auto remove = [&](auto& levels) {
+        auto level = levels.find(order.mPrice);
+        if (level == levels.end())
+            return;
+        level->second.mTotalVolume -= volume;
+        if (volume == order.mRemainingVolume)
+        {
+            auto& orders = level->second.mOrders;
+            auto it = std::find(orders.begin(), orders.end(), &order);
+            if (it != orders.end())
+                orders.erase(it);
+        }
+        if (level->second.mTotalVolume == 0)
+            levels.erase(level);
+    };
+
+    if (order.mSide == Side::SELL)
+        remove(mAsks);
+    else
+        remove(mBids);
+}
+
+}
@@ -0,0 +1,134 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_SIMULATOR_ORDERBOOK_H
+#define CPPREADY_TRADER_GO_LIBS_SIMULATOR_ORDERBOOK_H
+
+#include <array>
+#include <deque>
+#include <functional>
+#include <map>
+#include <utility>
+
+#include <ready_trader_go/types.h>
+
+namespace ReadyTraderGo {
+
+struct SimulatedOrder;
+
+// Receives the events affecting an order in a simulated order book.
+struct IOrderListener
+{
+    virtual ~IOrderListener() = default;
+    virtual void OnOrderAmended(double now, SimulatedOrder& order, unsigned long volumeRemoved) {};
+    virtual void OnOrderCancelled(double now, SimulatedOrder& order, unsigned long volumeRemoved) {};
+    virtual void OnOrderPlaced(double now, SimulatedOrder& order) {};
+    virtual void OnOrderFilled(double now,
+                               SimulatedOrder& order,
+                               unsigned long price,
+                               unsigned long volume,
+                               long fee) {};
+};
+
+// An order resting in, or being matched against, a simulated order book.
+// Orders are owned by the caller and must stay put while in a book.
+struct SimulatedOrder
+{
+    unsigned long mClientOrderId = 0;
+    Instrument mInstrument = Instrument::FUTURE;
+    Lifespan mLifespan = Lifespan::GOOD_FOR_DAY;
+    Side mSide = Side::SELL;
+    unsigned long mPrice = 0;
+    unsigned long mVolume = 0;
+    unsigned long mRemainingVolume = 0;
+    long mTotalFees = 0;
+    IOrderListener* mListener = nullptr;
+};
+
+// A collection of orders arranged by price-time priority, matching the
+// exchange simulator's order book (ready_trader_go/order_book.py),
+// including its fees and trade ticks.
+class OrderBook
+{
+public:
+    using LevelArray = std::array<unsigned long, TOP_LEVEL_COUNT>;
+
+    OrderBook(Instrument instrument, double makerFee, double takerFee);
+
+    OrderBook(const OrderBook&) = delete;
+    void operator=(const OrderBook&) = delete;
+
+    // Reduce an order's volume to newVolume (but not below what has already
+    // been filled).
+    void Amend(double now, SimulatedOrder& order, unsigned long newVolume);
+    void Cancel(double now, SimulatedOrder& order);
+    void Insert(double now, SimulatedOrder& order);
+
+    Instrument GetInstrument() const noexcept { return mInstrument; }
+
+    // Zero if that side of the book is empty
+    unsigned long BestAsk() const noexcept { return mAsks.empty() ? 0 : mAsks.begin()->first; }
+    unsigned long BestBid() const noexcept { return mBids.empty() ? 0 : mBids.begin()->first; }
+    // Zero if nothing has traded
+    unsigned long LastTradedPrice() const noexcept { return mLastTradedPrice; }
+
+    // Total volume resting at the given price on the given side.
+    unsigned long VolumeAt(Side side, unsigned long price) const;
+
+    void TopLevels(LevelArray& askPrices,
+                   LevelArray& askVolumes,
+                   LevelArray& bidPrices,
+                   LevelArray& bidVolumes) const;
+
+    // If there have been trades since the last call, fill in the traded
+    // volume at each price, clear it and return true.
+    bool TradeTicks(LevelArray& askPrices, LevelArray& askVolumes, LevelArray& bidPrices, LevelArray& bidVolumes);
+
+    // The volume that would trade, and its average price, if an order with
+    // the given side, limit price and volume were inserted now.
+    std::pair<unsigned long, unsigned long> TryTrade(Side side, unsigned long limitPrice, unsigned long volume) const;
+
+private:
+    struct Level
+    {
+        std::deque<SimulatedOrder*> mOrders;
+        unsigned long mTotalVolume = 0;
+    };
+
+    using AskLevels = std::map<unsigned long, Level>;
+    using BidLevels = std::map<unsigned long, Level, std::greater<>>;
+
+    template<typename Levels>
+    void Trade(double now, SimulatedOrder& order, Levels& levels);
+    void TradeLevel(double now, SimulatedOrder& order, unsigned long price, Level& level);
+    void Place(double now, SimulatedOrder& order);
+    void RemoveFromLevel(SimulatedOrder& order, unsigned long volume);
+
+    Instrument mInstrument;
+    double mMakerFee;
+    double mTakerFee;
+    unsigned long mLastTradedPrice = 0;
+
+    AskLevels mAsks;
+    BidLevels mBids;
+    std::map<unsigned long, unsigned long> mAskTicks;
+    std::map<unsigned long, unsigned long, std::greater<>> mBidTicks;
+};
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_SIMULATOR_ORDERBOOK_H
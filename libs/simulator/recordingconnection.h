@@ -0,0 +1,80 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_SIMULATOR_RECORDINGCONNECTION_H
+#define CPPREADY_TRADER_GO_LIBS_SIMULATOR_RECORDINGCONNECTION_H
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include <ready_trader_go/connectivity.h>
+#include <ready_trader_go/connectivitytypes.h>
+
+namespace ReadyTraderGo {
+
+// An execution connection that goes nowhere. Messages sent on it are
+// counted by type and passed to MessageSent, if set; nothing is ever
+// received except what is injected with Receive.
+class RecordingConnection : public IConnection
+{
+public:
+    RecordingConnection() : mBuffer(MAXIMUM_MESSAGE_SIZE) {}
+
+    void AsyncRead() override {}
+
+    using IConnection::SendMessage;
+    void SendMessage(unsigned char messageType, const ISerialisable& serialisable, SendMode mode) override
+    {
+        const std::size_t size = serialisable.Size();
+        serialisable.Serialise(PrepareMessage(messageType, size));
+        CommitMessage(size, mode);
+    }
+
+    unsigned char* PrepareMessage(unsigned char messageType, std::size_t) override
+    {
+        mMessageType = messageType;
+        return mBuffer.data();
+    }
+
+    void CommitMessage(std::size_t size, SendMode) override
+    {
+        ++mSentCounts[mMessageType];
+        if (MessageSent)
+            MessageSent(mMessageType, mBuffer.data(), size);
+    }
+
+    // Deliver a message to the connection's owner as if it had arrived.
+    void Receive(unsigned char messageType, unsigned char const* data, std::size_t size)
+    {
+        OnMessageReceipt(messageType, data, size);
+    }
+
+    std::size_t GetSentCount(unsigned char messageType) const { return mSentCounts[messageType]; }
+
+    std::function<void(unsigned char, unsigned char const*, std::size_t)> MessageSent;
+
+private:
+    std::vector<unsigned char> mBuffer;
+    unsigned char mMessageType = 0;
+    std::array<std::size_t, 256> mSentCounts = {};
+};
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_SIMULATOR_RECORDINGCONNECTION_H
@@ -0,0 +1,140 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include <ready_trader_go/error.h>
+
+#include "scoreboard.h"
+
+namespace ReadyTraderGo {
+
+namespace {
+
+constexpr char SCORE_BOARD_MAGIC[8] = {'R', 'T', 'G', 'S', 'C', 'O', 'R', 'E'};
+constexpr std::uint32_t SCORE_BOARD_VERSION = 1;
+
+struct ScoreBoardHeader
+{
+    char mMagic[8];
+    std::uint32_t mVersion;
+    std::uint32_t mRecordSize;
+};
+
+}
+
+void ScoreBoard::Add(ScoreEvent event, double now, const Account& account, unsigned long etfPrice,
+                     unsigned long futurePrice, long unhedgedLots)
+{
+    ScoreRecord& record = mRecords.emplace_back();
+    record.mTime = now;
+    record.mAccountBalance = account.GetAccountBalance();
+    record.mProfitOrLoss = account.GetProfitOrLoss();
+    record.mTotalFees = account.GetTotalFees();
+    record.mEtfPrice = static_cast<std::uint32_t>(etfPrice);
+    record.mFuturePrice = static_cast<std::uint32_t>(futurePrice);
+    record.mEtfPosition = static_cast<std::int32_t>(account.GetEtfPosition());
+    record.mFuturePosition = static_cast<std::int32_t>(account.GetFuturePosition());
+    record.mBuyVolume = static_cast<std::uint32_t>(account.GetBuyVolume());
+    record.mSellVolume = static_cast<std::uint32_t>(account.GetSellVolume());
+    record.mUnhedgedLots = static_cast<std::int32_t>(unhedgedLots);
+    record.mEvent = event;
+}
+
+void ScoreBoard::Write(const std::string& filename) const
+{
+    std::ofstream file{filename, std::ios::binary | std::ios::trunc};
+    if (!file)
+        throw ReadyTraderGoError("failed to open score board file: '" + filename + "'");
+
+    ScoreBoardHeader header{};
+    std::memcpy(header.mMagic, SCORE_BOARD_MAGIC, sizeof(header.mMagic));
+    header.mVersion = SCORE_BOARD_VERSION;
+    header.mRecordSize = sizeof(ScoreRecord);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(mRecords.data()),
+               static_cast<std::streamsize>(mRecords.size() * sizeof(ScoreRecord)));
+    file.flush();
+    if (!file)
+        throw ReadyTraderGoError("failed to write score board file: '" + filename + "'");
+}
+
+void readScoreBoard(const std::string& filename, std::vector<ScoreRecord>& records)
+{
+    std::ifstream file{filename, std::ios::binary | std::ios::ate};
+    if (!file)
+        throw ReadyTraderGoError("failed to open score board file: '" + filename + "'");
+    const auto size = static_cast<std::size_t>(file.tellg());
+    file.seekg(0);
+
+    ScoreBoardHeader header{};
+    if (size < sizeof(header)
+        || !file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.mMagic, SCORE_BOARD_MAGIC, sizeof(header.mMagic)) != 0)
+        throw ReadyTraderGoError("not a score board file: '" + filename + "'");
+    if (header.mVersion != SCORE_BOARD_VERSION || header.mRecordSize != sizeof(ScoreRecord))
+        throw ReadyTraderGoError("unsupported score board file version: '" + filename + "'");
+    if ((size - sizeof(header)) % sizeof(ScoreRecord) != 0)
+        throw ReadyTraderGoError("truncated score board file: '" + filename + "'");
+
+    records.resize((size - sizeof(header)) / sizeof(ScoreRecord));
+    if (!file.read(reinterpret_cast<char*>(records.data()),
+                   static_cast<std::streamsize>(records.size() * sizeof(ScoreRecord))))
+        throw ReadyTraderGoError("failed to read score board file: '" + filename + "'");
+}
+
+ScoreSummary summariseScores(const ScoreRecord* records, std::size_t count) noexcept
+{
+    ScoreSummary summary;
+    summary.mRecordCount = count;
+    if (count == 0)
+        return summary;
+
+    long maxProfit = 0;
+    long minProfitOrLoss = 0;
+    long maxDrawdown = 0;
+    long maxUnhedgedLots = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const long profitOrLoss = records[i].mProfitOrLoss;
+        maxProfit = std::max(maxProfit, profitOrLoss);
+        minProfitOrLoss = std::min(minProfitOrLoss, profitOrLoss);
+        maxDrawdown = std::max(maxDrawdown, maxProfit - profitOrLoss);
+        maxUnhedgedLots = std::max(maxUnhedgedLots, std::labs(records[i].mUnhedgedLots));
+        if (records[i].mEvent == ScoreEvent::BREACH && !summary.mBreached)
+        {
+            summary.mBreached = true;
+            summary.mBreachTime = records[i].mTime;
+        }
+    }
+
+    const ScoreRecord& last = records[count - 1];
+    summary.mEndTime = last.mTime;
+    summary.mProfitOrLoss = last.mProfitOrLoss;
+    summary.mMaxProfit = maxProfit;
+    summary.mMinProfitOrLoss = minProfitOrLoss;
+    summary.mMaxDrawdown = maxDrawdown;
+    summary.mTotalFees = last.mTotalFees;
+    summary.mEtfVolume = static_cast<unsigned long>(last.mBuyVolume) + last.mSellVolume;
+    summary.mMaxUnhedgedLots = maxUnhedgedLots;
+    return summary;
+}
+
+}
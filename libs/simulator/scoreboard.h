@@ -0,0 +1,129 @@
+// Copyright 2021 Optiver Asia Pacific Pty. Ltd.
+//
+// This file is part of Ready Trader Go.
+//
+//     Ready Trader Go is free software: you can redistribute it and/or
+//     modify it under the terms of the GNU Affero General Public License
+//     as published by the Free Software Foundation, either version 3 of
+//     the License, or (at your option) any later version.
+//
+//     Ready Trader Go is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU Affero General Public License for more details.
+//
+//     You should have received a copy of the GNU Affero General Public
+//     License along with Ready Trader Go.  If not, see
+//     <https://www.gnu.org/licenses/>.
+#ifndef CPPREADY_TRADER_GO_LIBS_SIMULATOR_SCOREBOARD_H
+#define CPPREADY_TRADER_GO_LIBS_SIMULATOR_SCOREBOARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "account.h"
+
+namespace ReadyTraderGo {
+
+enum class ScoreEvent : std::uint8_t { TICK, BREACH, DISCONNECT };
+
+// One row of a score board (as in the exchange's score_board.csv), laid out
+// to be written to and read from a file as it is. Prices and amounts are in
+// cents.
+struct ScoreRecord
+{
+    double mTime = 0.0;
+    std::int64_t mAccountBalance = 0;
+    std::int64_t mProfitOrLoss = 0;
+    std::int64_t mTotalFees = 0;
+    std::uint32_t mEtfPrice = 0;
+    std::uint32_t mFuturePrice = 0;
+    std::int32_t mEtfPosition = 0;
+    std::int32_t mFuturePosition = 0;
+    std::uint32_t mBuyVolume = 0;
+    std::uint32_t mSellVolume = 0;
+    std::int32_t mUnhedgedLots = 0;
+    ScoreEvent mEvent = ScoreEvent::TICK;
+    std::uint8_t mReserved[3] = {};
+};
+
+static_assert(sizeof(ScoreRecord) == 64, "score records are written to files as they are");
+
+// What a run's score board adds up to.
+struct ScoreSummary
+{
+    std::size_t mRecordCount = 0;
+    double mEndTime = 0.0;
+    long mProfitOrLoss = 0;
+    long mMaxProfit = 0;
+    long mMinProfitOrLoss = 0;
+    long mMaxDrawdown = 0;
+    long mTotalFees = 0;
+    unsigned long mEtfVolume = 0;
+    long mMaxUnhedgedLots = 0;
+    bool mBreached = false;
+    double mBreachTime = 0.0;
+};
+
+// A competitor's score over a match: a record each tick, and one for a
+// breach or disconnection.
+//
+// Score board files are a short header followed by the records in the
+// writing machine's byte order, so a run of several thousand ticks takes a
+// few hundred kilobytes and reads back with a single read.
+class ScoreBoard
+{
+public:
+    void Tick(double now, const Account& account, unsigned long etfPrice, unsigned long futurePrice,
+              long unhedgedLots);
+    void Breach(double now, const Account& account, unsigned long etfPrice, unsigned long futurePrice,
+                long unhedgedLots);
+    void Disconnect(double now, const Account& account, unsigned long etfPrice, unsigned long futurePrice,
+                    long unhedgedLots);
+
+    const std::vector<ScoreRecord>& GetRecords() const noexcept { return mRecords; }
+
+    // Throws ReadyTraderGoError if the file cannot be written.
+    void Write(const std::string& filename) const;
+
+private:
+    void Add(ScoreEvent event, double now, const Account& account, unsigned long etfPrice,
+             unsigned long futurePrice, long unhedgedLots);
+
+    std::vector<ScoreRecord> mRecords;
+};
+
+// Replace the records with those in a score board file. Throws
+// ReadyTraderGoError if the file cannot be read or is not a score board.
+void readScoreBoard(const std::string& filename, std::vector<ScoreRecord>& records);
+
+ScoreSummary summariseScores(const ScoreRecord* records, std::size_t count) noexcept;
+
+inline ScoreSummary summariseScores(const std::vector<ScoreRecord>& records) noexcept
+{
+    return summariseScores(records.data(), records.size());
+}
+
+inline void ScoreBoard::Tick(double now, const Account& account, unsigned long etfPrice,
+                             unsigned long futurePrice, long unhedgedLots)
+{
+    Add(ScoreEvent::TICK, now, account, etfPrice, futurePrice, unhedgedLots);
+}
+
+inline void ScoreBoard::Breach(double now, const Account& account, unsigned long etfPrice,
+                               unsigned long futurePrice, long unhedgedLots)
+{
+    Add(ScoreEvent::BREACH, now, account, etfPrice, futurePrice, unhedgedLots);
+}
+
+inline void ScoreBoard::Disconnect(double now, const Account& account, unsigned long etfPrice,
+                                   unsigned long futurePrice, long unhedgedLots)
+{
+    Add(ScoreEvent::DISCONNECT, now, account, etfPrice, futurePrice, unhedgedLots);
+}
+
+}
+
+#endif //CPPREADY_TRADER_GO_LIBS_SIMULATOR_SCOREBOARD_H